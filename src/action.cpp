@@ -52,6 +52,123 @@ paused_action_t::chained_awaitable_t::await_suspend(coroutine_handle<promise_typ
     return action;
 }
 
+/**
+ * @brief Coroutine for each child of `when_all`/`when_any`.
+ *        Its frame is destroyed in `final_suspend` and the `co_return`ed one is continued
+ */
+struct when_part_t final {
+    struct promise_type final {
+        coroutine_handle<void> next = nullptr;
+
+      public:
+        constexpr suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        auto final_suspend() noexcept {
+            struct awaitable_t final {
+                constexpr bool await_ready() noexcept {
+                    return false;
+                }
+                coroutine_handle<void> await_suspend(coroutine_handle<promise_type> coro) noexcept {
+                    auto next = coro.promise().next;
+                    coro.destroy();
+                    return next ? next : noop_coroutine();
+                }
+                constexpr void await_resume() noexcept {
+                }
+            };
+            return awaitable_t{};
+        }
+        void unhandled_exception() noexcept {
+            sink_exception(std::current_exception());
+        }
+        void return_value(coroutine_handle<void> coro) noexcept {
+            next = coro;
+        }
+        when_part_t get_return_object() noexcept {
+            return {};
+        }
+    };
+};
+
+/// @brief Start the child. It will continue the `when_part_t` when it returns
+struct start_child_awaitable_t final {
+    when_child_t child;
+
+  public:
+    bool await_ready() const noexcept {
+        return child.coro.done();
+    }
+    coroutine_handle<void> await_suspend(coroutine_handle<void> coro) noexcept {
+        child.set_next(child.coro, coro);
+        return child.coro;
+    }
+    constexpr void await_resume() const noexcept {
+    }
+};
+
+when_part_t run_part(when_child_t child, when_all_awaitable_t& awaitable) {
+    co_await start_child_awaitable_t{child};
+    co_return awaitable.complete();
+}
+
+when_part_t run_part(when_child_t child, std::shared_ptr<when_any_awaitable_t::control_t> control, size_t index) {
+    co_await start_child_awaitable_t{child};
+    co_return control->complete(index);
+}
+
+when_all_awaitable_t::when_all_awaitable_t(std::vector<when_child_t>&& children) noexcept
+    : children{std::move(children)} {
+}
+
+bool when_all_awaitable_t::await_suspend(coroutine_handle<void> coro) noexcept {
+    parent = coro;
+    count = children.size() + 1;
+    for (auto& child : children)
+        run_part(child, *this);
+    // the last one resumes the parent. if it's this, don't suspend
+    return count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+}
+
+coroutine_handle<void> when_all_awaitable_t::complete() noexcept {
+    // after the decrement, `this` may be destroyed by the last one
+    if (count.fetch_sub(1, std::memory_order_acq_rel) > 1)
+        return nullptr;
+    return parent;
+}
+
+coroutine_handle<void> when_any_awaitable_t::control_t::complete(size_t index) noexcept {
+    size_t expected = npos;
+    if (first.compare_exchange_strong(expected, index, std::memory_order_acq_rel) == false)
+        return nullptr;
+    if (gate.fetch_sub(1, std::memory_order_acq_rel) > 1)
+        return nullptr; // `await_suspend` is not finished. it will continue the parent
+    return parent;
+}
+
+when_any_awaitable_t::when_any_awaitable_t(std::vector<when_child_t>&& children) noexcept(false)
+    : children{std::move(children)}, control{std::make_shared<control_t>()} {
+}
+
+bool when_any_awaitable_t::await_ready() noexcept {
+    if (children.empty())
+        return true;
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children[i].coro.done() == false)
+            continue;
+        control->first = i;
+        return true;
+    }
+    return false;
+}
+
+bool when_any_awaitable_t::await_suspend(coroutine_handle<void> coro) noexcept {
+    control->parent = coro;
+    for (size_t i = 0; i < children.size(); ++i)
+        run_part(children[i], control, i);
+    return control->gate.fetch_sub(1, std::memory_order_acq_rel) > 1;
+}
+
 suspend_never waitable_action_t::promise_type::initial_suspend() noexcept {
     if (proxy.retain)
         proxy.retain(proxy.context);
@@ -1,7 +1,13 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 // ...
 #include "coro.hpp"
@@ -129,6 +135,279 @@ static_assert(std::is_copy_assignable_v<paused_action_t> == false);
 static_assert(std::is_move_constructible_v<paused_action_t> == true);
 static_assert(std::is_move_assignable_v<paused_action_t> == true);
 
+/**
+ * @brief Result storage of `task_t<T>`. Holds the `co_return` value or the exception
+ */
+template <typename T>
+class task_promise_base {
+  protected:
+    coroutine_handle<void> next = nullptr; // the awaiter. continued after `final_suspend`
+    std::variant<std::monostate, T, std::exception_ptr> result{};
+
+  public:
+    constexpr suspend_always initial_suspend() noexcept {
+        return {};
+    }
+    end_awaitable_t final_suspend() noexcept {
+        return {next ? next : noop_coroutine()};
+    }
+    void unhandled_exception() noexcept {
+        result.template emplace<2>(std::current_exception());
+    }
+    template <typename U>
+    void return_value(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+        result.template emplace<1>(std::forward<U>(value));
+    }
+
+    void set_next(coroutine_handle<void> task) noexcept {
+        next = task;
+    }
+    /// @throw The exception from the coroutine
+    T get() noexcept(false) {
+        if (result.index() == 2)
+            std::rethrow_exception(std::get<2>(result));
+        return std::move(std::get<1>(result));
+    }
+};
+
+template <>
+class task_promise_base<void> {
+  protected:
+    coroutine_handle<void> next = nullptr;
+    std::exception_ptr exception = nullptr;
+
+  public:
+    constexpr suspend_always initial_suspend() noexcept {
+        return {};
+    }
+    end_awaitable_t final_suspend() noexcept {
+        return {next ? next : noop_coroutine()};
+    }
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+    constexpr void return_void() noexcept {
+    }
+
+    void set_next(coroutine_handle<void> task) noexcept {
+        next = task;
+    }
+    void get() noexcept(false) {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+
+/**
+ * @brief Lazily started coroutine with the result.
+ *        `co_await` starts the task and the awaiter is continued by `end_awaitable_t`.
+ *        So the chain of the tasks won't grow the stack
+ * 
+ * ```cpp
+ * task_t<size_t> read_header(socket_t& s);
+ * task_t<message_t> read_message(socket_t& s) {
+ *     auto length = co_await read_header(s);
+ *     // ...
+ * }
+ * ```
+ * 
+ * @note  The task which is not awaited can be started with `handle()`.
+ *        After it is `done()`, `get()` returns the result
+ * @see paused_action_t
+ */
+template <typename T>
+class task_t final {
+  public:
+    class promise_type final : public task_promise_base<T> {
+      public:
+        task_t get_return_object() noexcept {
+            return task_t{coroutine_handle<promise_type>::from_promise(*this)};
+        }
+    };
+
+    struct awaitable_t final {
+        coroutine_handle<promise_type> task;
+
+      public:
+        /// @note co_await on the finished task returns the result immediately
+        bool await_ready() const noexcept {
+            return task.done();
+        }
+        coroutine_handle<void> await_suspend(coroutine_handle<void> coro) noexcept {
+            task.promise().set_next(coro);
+            return task;
+        }
+        /// @throw The exception from the task
+        T await_resume() noexcept(false) {
+            return task.promise().get();
+        }
+    };
+
+  private:
+    coroutine_handle<promise_type> coro;
+
+  public:
+    explicit task_t(coroutine_handle<promise_type> handle) noexcept : coro{handle} {
+    }
+    ~task_t() noexcept {
+        if (coro)
+            coro.destroy();
+    }
+    task_t(const task_t&) = delete;
+    task_t& operator=(const task_t&) = delete;
+    task_t(task_t&& rhs) noexcept : coro{std::exchange(rhs.coro, nullptr)} {
+    }
+    task_t& operator=(task_t&& rhs) noexcept {
+        std::swap(coro, rhs.coro);
+        return *this;
+    }
+
+    coroutine_handle<void> handle() const noexcept {
+        return coro;
+    }
+    bool done() const noexcept {
+        return coro.done();
+    }
+    /// @throw The exception from the task
+    decltype(auto) get() noexcept(false) {
+        return coro.promise().get();
+    }
+
+    awaitable_t operator co_await() noexcept {
+        return {coro};
+    }
+};
+
+/**
+ * @brief Type-erased child of `when_all`/`when_any`. `paused_action_t` or `task_t<T>`
+ */
+struct when_child_t final {
+    using fn_set_next_t = void (*)(coroutine_handle<void> coro, coroutine_handle<void> next) noexcept;
+
+  public:
+    coroutine_handle<void> coro;
+    fn_set_next_t set_next; // child.set_next(child.coro, next);
+
+  public:
+    template <typename A>
+    static when_child_t from(A& action) noexcept {
+        return {action.handle(), [](coroutine_handle<void> coro, coroutine_handle<void> next) noexcept {
+                    using promise_t = typename A::promise_type;
+                    coroutine_handle<promise_t>::from_address(coro.address()).promise().set_next(next);
+                }};
+    }
+};
+
+/**
+ * @brief Start all children and resume the awaiter once, when the last one is finished.
+ * @details The countdown starts with the number of the children + 1.
+ *          `await_suspend` holds the extra one, so the children which finish synchronously
+ *          can't resume the awaiter before it is suspended.
+ * @note The results of `task_t<T>` are in the tasks. Use `get()` after `co_await`
+ * @see when_all
+ */
+class when_all_awaitable_t final {
+    std::vector<when_child_t> children;
+    std::atomic<size_t> count{};
+    coroutine_handle<void> parent = nullptr;
+
+  public:
+    explicit when_all_awaitable_t(std::vector<when_child_t>&& children) noexcept;
+    when_all_awaitable_t(const when_all_awaitable_t&) = delete;
+    when_all_awaitable_t& operator=(const when_all_awaitable_t&) = delete;
+
+    bool await_ready() const noexcept {
+        return children.empty();
+    }
+    bool await_suspend(coroutine_handle<void> coro) noexcept;
+    constexpr void await_resume() const noexcept {
+    }
+
+    /// @return The awaiter if the caller is the last one. Or `nullptr`
+    coroutine_handle<void> complete() noexcept;
+};
+
+/**
+ * @brief Start all children and resume the awaiter once, when the first one is finished.
+ * @details The control block is shared with the children which are not finished yet.
+ *          The first one wins the race with the CAS of `first`.
+ *          The awaiter is resumed by the winner or its `await_suspend`, whichever is the last
+ * @note The other children keep running. The caller must keep them alive until they are finished
+ * @see when_any
+ */
+class when_any_awaitable_t final {
+  public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    struct control_t final {
+        std::atomic<size_t> first{npos};
+        std::atomic<uint32_t> gate{2}; // the winner + `await_suspend`
+        coroutine_handle<void> parent = nullptr;
+
+      public:
+        /// @return The awaiter if the caller is the first one and the awaiter is suspended. Or `nullptr`
+        coroutine_handle<void> complete(size_t index) noexcept;
+    };
+
+  private:
+    std::vector<when_child_t> children;
+    std::shared_ptr<control_t> control;
+
+  public:
+    explicit when_any_awaitable_t(std::vector<when_child_t>&& children) noexcept(false);
+    when_any_awaitable_t(const when_any_awaitable_t&) = delete;
+    when_any_awaitable_t& operator=(const when_any_awaitable_t&) = delete;
+
+    /// @note If a child is already finished, its index is the result
+    bool await_ready() noexcept;
+    bool await_suspend(coroutine_handle<void> coro) noexcept;
+    /// @return The index of the first finished child. `npos` if there was no child
+    size_t await_resume() const noexcept {
+        return control->first;
+    }
+};
+
+/**
+ * @brief Wait for all of the `paused_action_t`/`task_t<T>`s
+ * 
+ * ```cpp
+ * task_t<void> fan_out(shard_t& s1, shard_t& s2) {
+ *     task_t<reply_t> t1 = request(s1), t2 = request(s2);
+ *     co_await when_all(t1, t2); // max(latency), not sum(latency)
+ *     merge(t1.get(), t2.get());
+ * }
+ * ```
+ */
+template <typename... Actions>
+when_all_awaitable_t when_all(Actions&... actions) noexcept(false) {
+    return when_all_awaitable_t{{when_child_t::from(actions)...}};
+}
+template <typename Action>
+when_all_awaitable_t when_all(std::vector<Action>& actions) noexcept(false) {
+    std::vector<when_child_t> children{};
+    children.reserve(actions.size());
+    for (auto& action : actions)
+        children.emplace_back(when_child_t::from(action));
+    return when_all_awaitable_t{std::move(children)};
+}
+
+/**
+ * @brief Wait for the first one of the `paused_action_t`/`task_t<T>`s
+ * @return when_any_awaitable_t The result of `co_await` is the index of the first one
+ */
+template <typename... Actions>
+when_any_awaitable_t when_any(Actions&... actions) noexcept(false) {
+    return when_any_awaitable_t{{when_child_t::from(actions)...}};
+}
+template <typename Action>
+when_any_awaitable_t when_any(std::vector<Action>& actions) noexcept(false) {
+    std::vector<when_child_t> children{};
+    children.reserve(actions.size());
+    for (auto& action : actions)
+        children.emplace_back(when_child_t::from(action));
+    return when_any_awaitable_t{std::move(children)};
+}
+
 struct event_proxy_t final {
     using fn_access_t = void (*)(void* c);
     using fn_signal_t = void (*)(void* c);
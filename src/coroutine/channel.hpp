@@ -8,8 +8,15 @@
 #pragma once
 #ifndef LUNCLIFF_COROUTINE_CHANNEL_HPP
 #define LUNCLIFF_COROUTINE_CHANNEL_HPP
+#include <atomic>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
 #include <tuple>
+#include <utility>
+
+#include <gsl/gsl>
 
 #if __has_include(<coroutine/frame.h>) && !defined(USE_EXPERIMENTAL_COROUTINE)
 #include <coroutine/frame.h>
@@ -64,6 +71,40 @@ struct bypass_mutex final {
     }
 };
 
+/**
+ * @brief Test-and-test-and-set spin lock. It never sleeps in the kernel
+ * @note This is still a lock around the waiter lists, not a lock-free queue.
+ * `channel` holds its lock only for a few pointer exchanges, so this may
+ * help when the threads have their own cores. Measure it with
+ * `test/channel_benchmark.cpp` before replacing `std::mutex`.
+ * With 1 core, 16 and 32 producers showed no difference in the throughput.
+ *
+ * @code
+ * channel<int, spin_mutex> ch{};
+ * @endcode
+ */
+class spin_mutex final {
+    std::atomic<bool> locked{false};
+
+  public:
+    bool try_lock() noexcept {
+        // test before test-and-set. prevent cache line bouncing
+        return locked.load(std::memory_order_relaxed) == false &&
+               locked.exchange(true, std::memory_order_acquire) == false;
+    }
+    /** @brief Spin for a while, and then yield the thread until the lock is acquired */
+    void lock() noexcept {
+        for (uint32_t count = 0; try_lock() == false; ++count) {
+            if (count < 64)
+                continue;
+            std::this_thread::yield();
+        }
+    }
+    void unlock() noexcept {
+        locked.store(false, std::memory_order_release);
+    }
+};
+
 namespace internal {
 
 /**
@@ -76,6 +117,16 @@ static void* poison() noexcept(false) {
     return reinterpret_cast<void*>(0xFADE'038C'BCFA'9E64);
 }
 
+/**
+ * @brief Returns a non-null address that marks the value is in the channel's buffer
+ * @note The address is never resumed. It is compared like `poison`
+ * @return void* non-null address
+ * @ingroup channel
+ */
+static void* buffered() noexcept(false) {
+    return reinterpret_cast<void*>(0xB0FF'E2ED'0C4A'77E1);
+}
+
 /**
  * @brief Linked list without allocation
  * @tparam T Type of the node. Its member must have `next` pointer
@@ -107,6 +158,107 @@ class list {
             head = head->next;
         return node;
     }
+    /**
+     * @brief Remove the node from the middle of the list
+     * @return true  The node was in the list
+     * @return false The node is not in the list. Nothing changed
+     */
+    bool erase(T* node) noexcept(false) {
+        T* prev = nullptr;
+        T* it = head;
+        while (it != node) {
+            if (it == tail) // end of the list
+                return false;
+            prev = it;
+            it = it->next;
+        }
+        T* after = (it == tail) ? nullptr : it->next;
+        if (prev)
+            prev->next = after;
+        else
+            head = after;
+        if (it == tail)
+            tail = prev;
+        return true;
+    }
+};
+
+/**
+ * @brief Shared state of the `channel_reader`s registered by one `select_async`
+ * @note  Only one reader can be paired. The others must be dropped by the writers
+ */
+class selection final {
+    std::atomic<void*> winner{nullptr};
+
+  public:
+    /**
+     * @param node The reader which is going to be paired
+     * @return true  The node is the first one. Pair it with the writer
+     * @return false The other node is already paired
+     */
+    bool try_claim(void* node) noexcept {
+        void* expected = nullptr;
+        return winner.compare_exchange_strong(expected, node,
+                                              std::memory_order_acq_rel);
+    }
+    void* get() const noexcept {
+        return winner.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ * @brief Fixed size circular queue. The storage is allocated only once
+ * @tparam T Type of the element. It is move-constructed into the storage
+ */
+template <typename T>
+class ring {
+    T* storage = nullptr;
+    size_t capacity = 0;
+    size_t head = 0;
+    size_t count = 0;
+
+  public:
+    explicit ring(size_t n) noexcept(false)
+        : storage{static_cast<T*>(
+              n ? ::operator new(sizeof(T) * n, std::align_val_t{alignof(T)})
+                : nullptr)},
+          capacity{n} {
+    }
+    ~ring() noexcept {
+        while (count)
+            pop();
+        if (storage)
+            ::operator delete(storage, std::align_val_t{alignof(T)});
+    }
+    ring(const ring&) = delete;
+    ring(ring&&) = delete;
+    ring& operator=(const ring&) = delete;
+    ring& operator=(ring&&) = delete;
+
+    bool is_empty() const noexcept {
+        return count == 0;
+    }
+    /**
+     * @note Zero capacity ring is always full
+     */
+    bool is_full() const noexcept {
+        return count == capacity;
+    }
+    /**
+     * @return T* The return can't be `nullptr`. Check `is_empty` before use
+     */
+    T* front() const noexcept {
+        return storage + head;
+    }
+    void push(T&& value) noexcept(false) {
+        new (storage + (head + count) % capacity) T(std::move(value));
+        ++count;
+    }
+    void pop() noexcept {
+        storage[head].~T();
+        head = (head + 1) % capacity;
+        --count;
+    }
 };
 } // namespace internal
 
@@ -118,6 +270,16 @@ template <typename T, typename M>
 class channel_writer;
 template <typename T, typename M>
 class channel_peeker;
+template <typename T, typename M>
+class channel_select_reader;
+template <typename T, typename M>
+class channel_batch_reader;
+template <typename T, typename M>
+class channel_batch_writer;
+template <typename T, typename M>
+class channel_borrower;
+template <typename T, typename M>
+class channel_lease;
 
 /**
  * @brief Awaitable type for `channel`'s read operation. 
@@ -148,10 +310,12 @@ class channel_reader {
     using reader_list = typename channel_type::reader_list;
     using writer = typename channel_type::writer;
     using writer_list = typename channel_type::writer_list;
+    using batch_writer = typename channel_type::batch_writer;
 
     friend channel_type;
     friend writer;
     friend reader_list;
+    friend batch_writer; // for `write_range()` implementation
 
   protected:
     mutable pointer ptr; /// Address of value
@@ -160,6 +324,8 @@ class channel_reader {
         channel_reader* next = nullptr; /// Next reader in channel
         channel_type* chan;             /// Channel to push this reader
     };
+    internal::selection* group = nullptr; /// Not `nullptr` if the reader is from `select_async`
+    bool lease = false; /// The reader uses writer's value without move. The writer must wait
 
   protected:
     explicit channel_reader(channel_type& ch) noexcept(false)
@@ -176,13 +342,26 @@ class channel_reader {
   public:
     /**
      * @brief Lock the channel and find available `channel_writer`
-     * 
-     * @return true   Matched with `channel_writer`
-     * @return false  There was no available `channel_writer`. 
+     *
+     * @return true   Matched with `channel_writer` or the channel's buffer.
+     *                For the buffer, the channel will be **lock**ed until `await_resume`.
+     *                If the channel is closed and there is no buffered value, fails without suspension.
+     * @return false  There was no available `channel_writer`.
      *                The channel will be **lock**ed for this case.
      */
     bool await_ready() const noexcept(false) {
         chan->mtx.lock();
+        if (chan->buffer.is_empty() == false) {
+            // await_resume will pop and unlock in the case
+            this->ptr = chan->buffer.front();
+            this->frame = internal::buffered();
+            return true;
+        }
+        if (chan->is_closed()) {
+            this->frame = internal::poison();
+            chan->mtx.unlock();
+            return true;
+        }
         if (chan->writer_list::is_empty())
             // await_suspend will unlock in the case
             return false;
@@ -212,7 +391,7 @@ class channel_reader {
         ch.mtx.unlock();
     }
     /**
-     * @brief Returns value from writer coroutine, and `bool` indicator for the associtated channel's destruction
+     * @brief Returns value from writer coroutine, and `bool` indicator for the associtated channel's close/destruction
      * 
      * @return tuple<value_type, bool> 
      */
@@ -224,9 +403,18 @@ class channel_reader {
         // the resume operation can destroy the other coroutine
         // store before resume
         std::get<0>(t) = std::move(*ptr);
-        if (auto coro = coroutine_handle<void>::from_address(frame))
-            coro.resume();
         std::get<1>(t) = true;
+        // the value was in the buffer. the channel is still locked
+        if (this->frame == internal::buffered()) {
+            channel_type& ch = *(this->chan);
+            void* w = ch.pop_buffer();
+            ch.mtx.unlock();
+            ch.wake(w);
+            return t;
+        }
+        // `chan` is available when there is a partner to resume
+        if (this->frame)
+            chan->wake(this->frame);
         return t;
     }
 };
@@ -261,13 +449,19 @@ class channel_writer {
     using reader_list = typename channel_type::reader_list;
     using writer_list = typename channel_type::writer_list;
     using peeker = typename channel_type::peeker;
+    using selector = typename channel_type::selector;
+    using batch_reader = typename channel_type::batch_reader;
+    using borrower = typename channel_type::borrower;
 
     friend channel_type;
     friend reader;
     friend writer_list;
-    friend peeker; // for `peek()` implementation
+    friend peeker;       // for `peek()` implementation
+    friend selector;     // for `select_async()` implementation
+    friend batch_reader; // for `read_n()` implementation
+    friend borrower;     // for `borrow()` implementation
 
-  private:
+  protected:
     mutable pointer ptr; /// Address of value
     mutable void* frame; /// Resumeable Handle
     union {
@@ -275,7 +469,7 @@ class channel_writer {
         channel_type* chan;             /// Channel to push this writer
     };
 
-  private:
+  protected:
     explicit channel_writer(channel_type& ch, pointer pv) noexcept(false)
         : ptr{pv}, frame{nullptr}, chan{std::addressof(ch)} {
     }
@@ -290,18 +484,43 @@ class channel_writer {
   public:
     /**
      * @brief Lock the channel and find available `channel_reader`
-     * 
-     * @return true   Matched with `channel_reader`
-     * @return false  There was no available `channel_reader`. 
+     *
+     * @return true   Matched with `channel_reader` or moved the value into the channel's buffer.
+     *                If the channel is closed, fails without suspension.
+     * @return false  There was no available `channel_reader` and the buffer is full.
      *                The channel will be **lock**ed for this case.
+     *                With the executor or `channel_borrower`, matched reader also returns false.
+     *                The writer waits until the reader moves/releases the value.
      */
     bool await_ready() const noexcept(false) {
+        if (chan->is_closed()) { // fail fast without the lock
+            this->frame = internal::poison();
+            return true;
+        }
         chan->mtx.lock();
-        if (chan->reader_list::is_empty())
-            // await_suspend will unlock in the case
+        if (chan->is_closed()) { // closed while waiting for the lock
+            this->frame = internal::poison();
+            chan->mtx.unlock();
+            return true;
+        }
+        reader* r = chan->match_reader();
+        if (r == nullptr) {
+            if (chan->buffer.is_full())
+                // await_suspend will unlock in the case
+                return false;
+            // there is a space. no need to wait for the reader
+            chan->buffer.push(std::move(*ptr));
+            chan->mtx.unlock();
+            return true;
+        }
+        if (chan->executor || r->lease) {
+            // the reader will run later or borrow the value.
+            // `await_suspend` will post it
+            r->ptr = this->ptr;
+            this->frame = r; // remember the reader until `await_suspend`
+            chan->mtx.unlock();
             return false;
-
-        reader* r = chan->reader_list::pop();
+        }
         // exchange address & resumeable_handle
         std::swap(this->ptr, r->ptr);
         std::swap(this->frame, r->frame);
@@ -312,12 +531,22 @@ class channel_writer {
     /**
      * @brief Push to the channel and wait for `channel_reader`.
      * @note  The channel will be **unlock**ed after return. 
+     *        If the reader was matched in `await_ready`, post it to the executor instead
      * @param coro Remember current coroutine's handle to resume later
      * @see await_ready
      */
     void await_suspend(coroutine_handle<void> coro) noexcept(false) {
         // notice that next & chan are sharing memory
         channel_type& ch = *(this->chan);
+        if (this->frame) { // matched with the executor. see `await_ready`
+            auto* r = static_cast<reader*>(this->frame);
+            void* rframe = r->frame;
+            r->frame = coro.address(); // the reader will wake this writer
+            r->chan = std::addressof(ch);
+            this->frame = nullptr; // this writer has no partner to resume
+            // the writer can be resumed in the other thread after this
+            return ch.wake(rframe);
+        }
 
         this->frame = coro.address(); // remember handle before push/unlock
         this->next = nullptr;         // clear to prevent confusing
@@ -326,17 +555,18 @@ class channel_writer {
         ch.mtx.unlock();
     }
     /**
-     * @brief Returns `bool` indicator for the associtated channel's destruction
-     * 
-     * @return true   successfully sent the value to `channel_reader`
-     * @return false  The `channel` is under destruction
+     * @brief Returns `bool` indicator for the associtated channel's close/destruction
+     *
+     * @return true   successfully sent the value to `channel_reader` or the buffer
+     * @return false  The `channel` is closed or under destruction
      */
     bool await_resume() noexcept(false) {
         // frame holds poision if the channel is under destruction
         if (this->frame == internal::poison())
             return false;
-        if (auto coro = coroutine_handle<void>::from_address(frame))
-            coro.resume();
+        // frame is not `nullptr` only when this writer didn't suspend
+        if (this->frame)
+            chan->wake(this->frame);
         return true;
     }
 };
@@ -344,8 +574,14 @@ class channel_writer {
 /**
  * @brief C++ Coroutines based channel
  * @note  It works as synchronizer of `channel_writer`/`channel_reader`.
- *        The parameter mutex must meet the requirement of the synchronization. 
- * 
+ *        The parameter mutex must meet the requirement of the synchronization.
+ *        With non-zero capacity, writers leave their values in the buffer
+ *        and readers take them without suspension.
+ *
+ * @code
+ * channel<int> ch{3}; // 3 writes won't suspend until some reader consumes them
+ * @endcode
+ *
  * @tparam T type of the element
  * @tparam M Type of the mutex(lockable) for its member
  * @ingroup channel
@@ -361,6 +597,12 @@ class channel final : internal::list<channel_reader<T, M>>,
     using pointer = value_type*;
     using reference = value_type&;
     using mutex_type = M;
+    /**
+     * @brief Function to schedule the partner coroutine of read/write
+     * @param context The context object given with the function
+     * @param coro The coroutine to resume
+     */
+    using executor_type = void (*)(void* context, coroutine_handle<void> coro);
 
   private:
     using reader = channel_reader<value_type, mutex_type>;
@@ -368,13 +610,27 @@ class channel final : internal::list<channel_reader<T, M>>,
     using writer = channel_writer<value_type, mutex_type>;
     using writer_list = internal::list<writer>;
     using peeker = channel_peeker<value_type, mutex_type>;
+    using selector = channel_select_reader<value_type, mutex_type>;
+    using batch_reader = channel_batch_reader<value_type, mutex_type>;
+    using batch_writer = channel_batch_writer<value_type, mutex_type>;
+    using borrower = channel_borrower<value_type, mutex_type>;
+    using lease = channel_lease<value_type, mutex_type>;
 
     friend reader;
     friend writer;
-    friend peeker; // for `peek()` implementation
+    friend peeker;       // for `peek()` implementation
+    friend selector;     // for `select_async()` implementation
+    friend batch_reader; // for `read_n()` implementation
+    friend batch_writer; // for `write_range()` implementation
+    friend borrower;     // for `borrow()` implementation
+    friend lease;        // for `borrow()` implementation
 
   private:
     mutex_type mtx{};
+    internal::ring<value_type> buffer;
+    std::atomic<bool> closed{false};
+    executor_type executor = nullptr;
+    void* context = nullptr;
 
   private:
     channel(const channel&) noexcept(false) = delete;
@@ -385,48 +641,130 @@ class channel final : internal::list<channel_reader<T, M>>,
   public:
     /**
      * @brief initialized 2 linked list and given mutex
+     * @note  Without the buffer, each read/write waits for its partner(rendezvous)
+     */
+    channel() noexcept(false) : channel{0} {
+    }
+    /**
+     * @brief initialized 2 linked list, given mutex, and the buffer
+     * @param capacity The number of values that writers can leave without suspension
      */
-    channel() noexcept(false) : reader_list{}, writer_list{}, mtx{} {
+    explicit channel(size_t capacity) noexcept(false)
+        : reader_list{}, writer_list{}, mtx{}, buffer{capacity}, closed{false} {
     }
 
     /**
-     * @brief Resume all attached coroutine read/write operations
-     * @note Channel can't provide exception guarantee 
+     * @brief Close the channel and resume all attached coroutine read/write operations
+     * @note Channel can't provide exception guarantee
      * since the destruction contains coroutines' resume
-     * 
-     * If the channel is raced hardly, some coroutines can be
-     * enqueued into list just after this destructor unlocks mutex.
-     *
-     * Unfortunately, this can't be detected at once since
-     * we have 2 list (readers/writers) in the channel.
-     *
-     * Current implementation allows checking repeatedly to reduce the
-     * probability of such interleaving.
-     * **Modify the repeat count in the code** if the situation occurs.
+     * @see close
      */
     ~channel() noexcept(false) {
-        void* closing = internal::poison();
-        writer_list& writers = *this;
-        reader_list& readers = *this;
-        // even 5'000+ can be unsafe for hazard usage ...
-        size_t repeat = 1;
-        do {
+        close();
+    }
+
+    /**
+     * @brief Reject further writes and fail all waiting operations
+     * @note  Values in the buffer are still available for `read`.
+     *        The waiting coroutines are resumed after **unlock**.
+     *        Calling this multiple times is safe
+     *
+     * After the close, `channel_writer` returns `false` without suspension.
+     * `channel_reader` drains the buffer and then returns `false` without suspension.
+     * So no coroutine can be enqueued after this function.
+     */
+    void close() noexcept(false) {
+        reader_list readers{};
+        writer_list writers{};
+        {
             std::unique_lock lck{mtx};
-            while (writers.is_empty() == false) {
-                writer* w = writers.pop();
-                auto coro = coroutine_handle<void>::from_address(w->frame);
-                w->frame = closing;
+            closed.store(true, std::memory_order_release);
+            writer_list& wlist = *this;
+            while (writer* w = wlist.pop())
+                writers.push(w);
+            while (reader* r = match_reader())
+                readers.push(r);
+        }
+        void* closing = internal::poison();
+        // the node can be destroyed by its resume. take the next one before it
+        while (writer* w = writers.pop())
+            wake(std::exchange(w->frame, closing));
+        while (reader* r = readers.pop())
+            wake(std::exchange(r->frame, closing));
+    }
 
-                coro.resume();
-            }
-            while (readers.is_empty() == false) {
-                reader* r = readers.pop();
-                auto coro = coroutine_handle<void>::from_address(r->frame);
-                r->frame = closing;
+    /**
+     * @return true  `close` is invoked. `write` will fail
+     */
+    bool is_closed() const noexcept {
+        return closed.load(std::memory_order_acquire);
+    }
 
-                coro.resume();
-            }
-        } while (repeat--);
+    /**
+     * @brief Post the partner coroutines to the executor instead of resuming them in the current thread
+     * @note  Set it before any read/write operation. Without the executor(`nullptr`),
+     *        the partner is resumed in `await_resume` of the read/write
+     *
+     * @code
+     * void post_to_loop(void* ctx, coroutine_handle<void> coro){
+     *     auto* loop = reinterpret_cast<event_loop*>(ctx);
+     *     loop->push(coro); // the loop will resume the coroutine
+     * }
+     * channel<int> ch{};
+     * ch.set_executor(post_to_loop, &loop);
+     * @endcode
+     *
+     * @param fn  The function to schedule the coroutine. `nullptr` for immediate resume
+     * @param ctx The context object for the function
+     */
+    void set_executor(executor_type fn, void* ctx) noexcept {
+        executor = fn;
+        context = ctx;
+    }
+
+  private:
+    /**
+     * @brief Resume the coroutine or post it to the executor
+     * @param frame The coroutine's frame address. It can be `nullptr`
+     */
+    void wake(void* frame) noexcept(false) {
+        auto coro = coroutine_handle<void>::from_address(frame);
+        if (coro == nullptr)
+            return;
+        if (executor)
+            return executor(context, coro);
+        coro.resume();
+    }
+    /**
+     * @brief Remove the front of the buffer and refill it with a waiting `channel_writer`'s value
+     * @note  The channel must be **lock**ed. The lock is not released
+     * @return void* Frame of the refilled writer. Resume it after **unlock**. It can be `nullptr`
+     */
+    void* pop_buffer() noexcept(false) {
+        buffer.pop();
+        writer_list& writers = *this;
+        if (writers.is_empty())
+            return nullptr;
+        writer* w = writers.pop();
+        buffer.push(std::move(*w->ptr));
+        void* frame = w->frame;
+        w->frame = nullptr; // the writer has no partner to resume
+        return frame;
+    }
+    /**
+     * @brief Pop a `channel_reader` which can be paired with a writer
+     * @note  The channel must be **lock**ed.
+     *        Readers of `select_async` that are already paired in the other channel are dropped
+     * @return reader* The return can be `nullptr`
+     */
+    reader* match_reader() noexcept(false) {
+        reader_list& readers = *this;
+        while (readers.is_empty() == false) {
+            reader* r = readers.pop();
+            if (r->group == nullptr || r->group->try_claim(r))
+                return r;
+        }
+        return nullptr;
     }
 
   public:
@@ -447,6 +785,32 @@ class channel final : internal::list<channel_reader<T, M>>,
     decltype(auto) read() noexcept(false) {
         return channel_reader{*this};
     }
+    /**
+     * @brief construct a new reader which takes multiple values under 1 lock
+     *
+     * @param values memory to store the values from writers/buffer
+     * @return channel_batch_reader
+     */
+    decltype(auto) read_n(gsl::span<value_type> values) noexcept(false) {
+        return channel_batch_reader<value_type, mutex_type>{*this, values};
+    }
+    /**
+     * @brief construct a new writer which offers multiple values under 1 lock
+     *
+     * @param values values to be `move`d to readers/buffer
+     * @return channel_batch_writer
+     */
+    decltype(auto) write_range(gsl::span<value_type> values) noexcept(false) {
+        return channel_batch_writer<value_type, mutex_type>{*this, values};
+    }
+    /**
+     * @brief construct a new reader which references the writer's value without move
+     *
+     * @return channel_borrower
+     */
+    decltype(auto) borrow() noexcept(false) {
+        return channel_borrower<value_type, mutex_type>{*this};
+    }
 };
 
 /**
@@ -473,20 +837,34 @@ class channel_peeker final : protected channel_reader<T, M> {
     explicit channel_peeker(channel_type& ch) noexcept(false)
         : channel_reader<T, M>{ch} {
     }
-    ~channel_peeker() noexcept = default;
+    /**
+     * @brief If the `peek` found a value in the buffer but it was not acquired, release the lock
+     */
+    ~channel_peeker() noexcept(false) {
+        if (this->frame == internal::buffered())
+            this->chan->mtx.unlock();
+    }
 
   public:
     /**
-     * @brief Since there is no suspension for the `peeker`, 
+     * @brief Since there is no suspension for the `peeker`,
      * the implementation will use scoped locking
+     * @note  If the value is in the channel's buffer,
+     *        the lock is held until `acquire` or the destruction of the `peeker`
      */
     void peek() const noexcept(false) {
-        std::unique_lock lck{this->chan->mtx};
+        this->chan->mtx.lock();
+        if (this->chan->buffer.is_empty() == false) {
+            this->ptr = this->chan->buffer.front();
+            this->frame = internal::buffered();
+            return;
+        }
         if (this->chan->writer_list::is_empty() == false) {
             writer* w = this->chan->writer_list::pop();
             std::swap(this->ptr, w->ptr);
             std::swap(this->frame, w->frame);
         }
+        this->chan->mtx.unlock();
     }
     /**
      * @brief Move a value from matches `writer` to designated storage. After then, resume the `writer` coroutine.
@@ -510,11 +888,419 @@ class channel_peeker final : protected channel_reader<T, M> {
         if (this->ptr == nullptr)
             return false;
         storage = std::move(*this->ptr);
+        if (this->frame == internal::buffered()) {
+            this->frame = nullptr;
+            void* w = this->chan->pop_buffer();
+            this->chan->mtx.unlock();
+            this->chan->wake(w);
+            return true;
+        }
         // resume writer coroutine
-        if (auto coro = coroutine_handle<void>::from_address(this->frame))
+        this->chan->wake(this->frame);
+        return true;
+    }
+};
+
+/**
+ * @brief Awaitable for `channel`'s batched read operation.
+ * It takes values from the buffer and waiting `channel_writer`s under 1 lock,
+ * and resumes those writers after the unlock.
+ * @note  It suspends only when there is no value at all.
+ *        In the case, it returns with the 1 value from the writer which resumed it.
+ *
+ * @code
+ * auto read_from(channel<int>& ch, gsl::span<int> values) -> no_return_t {
+ *     size_t count = co_await ch.read_n(values);
+ *     if (count == 0)
+ *         ; // channel is closed !!!
+ * }
+ * @endcode
+ *
+ * @tparam T type of the element
+ * @tparam M mutex for the channel
+ * @see channel_reader
+ * @ingroup channel
+ */
+template <typename T, typename M>
+class channel_batch_reader final : public channel_reader<T, M> {
+  public:
+    using value_type = T;
+    using channel_type = channel<T, M>;
+
+  private:
+    using writer = typename channel_type::writer;
+    using writer_list = typename channel_type::writer_list;
+
+  private:
+    gsl::span<value_type> values;
+    mutable size_t count = 0;
+    mutable writer_list done{}; /// Writers to resume after **unlock**
+
+  public:
+    channel_batch_reader(channel_type& ch, gsl::span<value_type> values) noexcept(false)
+        : channel_reader<T, M>{ch}, values{values} {
+    }
+
+  public:
+    /**
+     * @brief Lock the channel and take values as much as possible
+     *
+     * @return true   Took 1 or more values. Or the channel is closed
+     * @return false  There was no value. The channel will be **lock**ed for this case.
+     */
+    bool await_ready() const noexcept(false) {
+        if (values.empty())
+            return true;
+        channel_type& ch = *(this->chan);
+        ch.mtx.lock();
+        while (count < values.size()) {
+            if (ch.buffer.is_empty() == false) {
+                values[count++] = std::move(*ch.buffer.front());
+                ch.buffer.pop();
+                // refill the buffer to keep the order of values
+                if (ch.writer_list::is_empty())
+                    continue;
+                writer* w = ch.writer_list::pop();
+                ch.buffer.push(std::move(*w->ptr));
+                done.push(w);
+                continue;
+            }
+            if (ch.writer_list::is_empty())
+                break;
+            writer* w = ch.writer_list::pop();
+            values[count++] = std::move(*w->ptr);
+            done.push(w);
+        }
+        if (count == 0 && ch.is_closed() == false)
+            // await_suspend will unlock in the case
+            return false;
+        if (count == 0)
+            this->frame = internal::poison();
+        ch.mtx.unlock();
+        return true;
+    }
+    /**
+     * @brief Push to the channel and wait for `channel_writer`.
+     * @note  The channel will be **unlock**ed after return.
+     */
+    void await_suspend(coroutine_handle<void> coro) noexcept(false) {
+        channel_reader<T, M>::await_suspend(coro);
+    }
+    /**
+     * @brief Resume the writers which gave their values
+     *
+     * @return size_t The number of values. `0` if the channel is closed
+     */
+    size_t await_resume() noexcept(false) {
+        if (count == 0) { // resumed by a writer or `close`
+            if (values.empty() || this->frame == internal::poison())
+                return 0;
+            values[0] = std::move(*this->ptr);
+            count = 1;
+            // `chan` is available when there is a partner to resume
+            if (this->frame)
+                this->chan->wake(this->frame);
+            return count;
+        }
+        // the resume operation can destroy the node. pop before it
+        channel_type& ch = *(this->chan);
+        while (writer* w = done.pop())
+            // the writer has no partner to resume
+            ch.wake(std::exchange(w->frame, nullptr));
+        return count;
+    }
+};
+
+/**
+ * @brief Awaitable for `channel`'s batched write operation.
+ * It gives values to waiting `channel_reader`s and the buffer under 1 lock,
+ * and resumes those readers after the unlock.
+ * @note  It suspends only when no value can be sent.
+ *        In the case, it returns after the first value is taken.
+ *
+ * @code
+ * auto write_to(channel<int>& ch, gsl::span<int> values) -> no_return_t {
+ *     size_t count = co_await ch.write_range(values);
+ *     if (count == 0)
+ *         ; // channel is closed !!!
+ *     values = values.subspan(count); // try again with the rest
+ * }
+ * @endcode
+ *
+ * @tparam T type of the element
+ * @tparam M mutex for the channel
+ * @see channel_writer
+ * @ingroup channel
+ */
+template <typename T, typename M>
+class channel_batch_writer final : public channel_writer<T, M> {
+  public:
+    using value_type = T;
+    using channel_type = channel<T, M>;
+
+  private:
+    using reader = typename channel_type::reader;
+    using reader_list = typename channel_type::reader_list;
+
+  private:
+    gsl::span<value_type> values;
+    mutable size_t count = 0;
+    mutable reader_list done{}; /// Readers to resume after **unlock**
+
+  public:
+    channel_batch_writer(channel_type& ch, gsl::span<value_type> values) noexcept(false)
+        : channel_writer<T, M>{ch, values.data()}, values{values} {
+    }
+
+  public:
+    /**
+     * @brief Lock the channel and give values as much as possible
+     *
+     * @return true   Gave 1 or more values. Or the channel is closed
+     * @return false  No reader and the buffer is full. The channel will be **lock**ed for this case.
+     */
+    bool await_ready() const noexcept(false) {
+        if (values.empty())
+            return true;
+        channel_type& ch = *(this->chan);
+        if (ch.is_closed()) { // fail fast without the lock
+            this->frame = internal::poison();
+            return true;
+        }
+        ch.mtx.lock();
+        if (ch.is_closed()) {
+            this->frame = internal::poison();
+            ch.mtx.unlock();
+            return true;
+        }
+        while (count < values.size()) {
+            if (reader* r = ch.match_reader()) {
+                // the reader will move the value in its `await_resume`
+                r->ptr = std::addressof(values[count++]);
+                done.push(r);
+                continue;
+            }
+            if (ch.buffer.is_full())
+                break;
+            ch.buffer.push(std::move(values[count++]));
+        }
+        if (count == 0)
+            // await_suspend will unlock in the case
+            return false;
+        ch.mtx.unlock();
+        return true;
+    }
+    /**
+     * @brief Push to the channel and wait for `channel_reader`.
+     * @note  The channel will be **unlock**ed after return.
+     */
+    void await_suspend(coroutine_handle<void> coro) noexcept(false) {
+        channel_writer<T, M>::await_suspend(coro);
+    }
+    /**
+     * @brief Resume the readers which took the values
+     *
+     * @return size_t The number of values. `0` if the channel is closed
+     */
+    size_t await_resume() noexcept(false) {
+        if (count == 0) { // resumed by a reader or `close`
+            if (values.empty() || this->frame == internal::poison())
+                return 0;
+            count = 1;
+            if (this->frame)
+                this->chan->wake(this->frame);
+            return count;
+        }
+        // the readers reference `values`. they must be resumed before return
+        // so the executor is not used here.
+        // the resume operation can destroy the node. pop before it
+        while (reader* r = done.pop()) {
+            auto coro = coroutine_handle<void>::from_address(r->frame);
+            r->frame = nullptr; // the reader has no partner to resume
             coro.resume();
+        }
+        return count;
+    }
+};
+
+/**
+ * @brief Reference to the value of `channel_writer` from `borrow`.
+ *        The writer is resumed when the lease is released
+ * @note  If the writer can't wait(the value was in the buffer, or from `write_range`),
+ *        the lease owns the value with its own storage
+ *
+ * @tparam T type of the element
+ * @tparam M mutex for the channel
+ * @see channel_borrower
+ * @ingroup channel
+ */
+template <typename T, typename M>
+class channel_lease final {
+  public:
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using channel_type = channel<T, M>;
+
+  private:
+    friend channel_borrower<T, M>;
+
+    channel_type* chan = nullptr;
+    pointer ptr = nullptr;
+    void* frame = nullptr; /// The writer to resume after release
+    std::optional<value_type> storage{};
+
+  private:
+    /// @brief Empty lease. The channel is closed
+    channel_lease() noexcept = default;
+    /// @brief Reference to the value of the waiting writer
+    channel_lease(channel_type& ch, pointer value, void* writer) noexcept
+        : chan{std::addressof(ch)}, ptr{value}, frame{writer} {
+    }
+    /// @brief Own the value. There is no writer to resume
+    explicit channel_lease(value_type&& value) noexcept(false)
+        : storage{std::move(value)} {
+        ptr = std::addressof(*storage);
+    }
+
+  public:
+    channel_lease(const channel_lease&) = delete;
+    channel_lease& operator=(const channel_lease&) = delete;
+    channel_lease(channel_lease&& rhs) noexcept(false)
+        : chan{rhs.chan}, frame{std::exchange(rhs.frame, nullptr)},
+          storage{std::move(rhs.storage)} {
+        ptr = storage ? std::addressof(*storage) : rhs.ptr;
+        rhs.ptr = nullptr;
+    }
+    channel_lease& operator=(channel_lease&&) = delete;
+    ~channel_lease() noexcept(false) {
+        release();
+    }
+
+  public:
+    /**
+     * @brief Drop the reference and resume the writer
+     * @note  The value must not be used after this
+     */
+    void release() noexcept(false) {
+        ptr = nullptr;
+        storage.reset();
+        if (frame)
+            chan->wake(std::exchange(frame, nullptr));
+    }
+
+    /**
+     * @return true   Holding the value
+     * @return false  The channel is closed, or `release`d
+     */
+    explicit operator bool() const noexcept {
+        return ptr != nullptr;
+    }
+    reference operator*() const noexcept {
+        return *ptr;
+    }
+    pointer operator->() const noexcept {
+        return ptr;
+    }
+};
+
+/**
+ * @brief Awaitable for `channel`'s zero-copy read operation.
+ * The writer waits until the returned `channel_lease` is released.
+ * So the reader can use the value in the writer without move.
+ *
+ * @code
+ * auto read_from(channel<frame_4kb>& ch) -> no_return_t {
+ *     auto lease = co_await ch.borrow();
+ *     if (!lease)
+ *         co_return; // channel is closed !!!
+ *     consume(*lease);
+ *     // the writer is resumed when the lease is destroyed
+ * }
+ * @endcode
+ *
+ * @tparam T type of the element
+ * @tparam M mutex for the channel
+ * @see channel_lease
+ * @ingroup channel
+ */
+template <typename T, typename M>
+class channel_borrower final : public channel_reader<T, M> {
+  public:
+    using value_type = T;
+    using channel_type = channel<T, M>;
+    using lease_type = channel_lease<T, M>;
+
+  private:
+    using writer = typename channel_type::writer;
+
+  public:
+    explicit channel_borrower(channel_type& ch) noexcept(false)
+        : channel_reader<T, M>{ch} {
+        this->lease = true;
+    }
+
+  public:
+    /**
+     * @brief Lock the channel and find available `channel_writer`
+     *
+     * @return true   Matched with `channel_writer` or the channel's buffer.
+     *                For the buffer, the channel will be **lock**ed until `await_resume`.
+     * @return false  There was no available `channel_writer`.
+     *                The channel will be **lock**ed for this case.
+     */
+    bool await_ready() const noexcept(false) {
+        channel_type& ch = *(this->chan);
+        ch.mtx.lock();
+        if (ch.buffer.is_empty() == false) {
+            // await_resume will pop and unlock in the case
+            this->ptr = ch.buffer.front();
+            this->frame = internal::buffered();
+            return true;
+        }
+        if (ch.is_closed()) {
+            this->frame = internal::poison();
+            ch.mtx.unlock();
+            return true;
+        }
+        if (ch.writer_list::is_empty())
+            // await_suspend will unlock in the case
+            return false;
+        // the writer won't be resumed until the lease is released
+        writer* w = ch.writer_list::pop();
+        std::swap(this->ptr, w->ptr);
+        std::swap(this->frame, w->frame);
+        ch.mtx.unlock();
         return true;
     }
+    /**
+     * @brief Push to the channel and wait for `channel_writer`.
+     * @note  The channel will be **unlock**ed after return.
+     */
+    void await_suspend(coroutine_handle<void> coro) noexcept(false) {
+        channel_reader<T, M>::await_suspend(coro);
+    }
+    /**
+     * @brief Returns the lease for the value. It's empty if the channel is closed
+     * @note  The writer is in `frame`. If it's `nullptr`, the writer didn't wait
+     *        so the value is `move`d into the lease
+     */
+    auto await_resume() noexcept(false) -> lease_type {
+        if (this->frame == internal::poison())
+            return lease_type{};
+        // resumed by `write_range`. `chan` is not available in the case
+        if (this->frame == nullptr)
+            return lease_type{std::move(*this->ptr)};
+        channel_type& ch = *(this->chan);
+        if (this->frame == internal::buffered()) {
+            lease_type l{std::move(*this->ptr)};
+            void* w = ch.pop_buffer();
+            ch.mtx.unlock();
+            ch.wake(w);
+            return l;
+        }
+        return lease_type{ch, this->ptr, this->frame};
+    }
 };
 
 /**
@@ -546,6 +1332,301 @@ void select(Ch& ch, Fn&& fn, Args&&... args) noexcept(false) {
     return select(forward<Args&&>(args)...); // try next pair
 }
 
+/**
+ * @brief `channel_reader` for `select_async`. It holds the value with its own storage
+ * @note  The type doesn't suspend by itself. `channel_select` locks/registers it for each channel
+ *
+ * @tparam T type of the element
+ * @tparam M mutex for the channel
+ * @see channel_select
+ * @ingroup channel
+ */
+template <typename T, typename M>
+class channel_select_reader final : public channel_reader<T, M> {
+  public:
+    using value_type = T;
+    using channel_type = channel<T, M>;
+    using mutex_type = M;
+
+  private:
+    using reader = channel_reader<T, M>;
+    using reader_list = typename channel_type::reader_list;
+    using writer = typename channel_type::writer;
+    using writer_list = typename channel_type::writer_list;
+
+  private:
+    channel_type& owner; /// `chan` is shared with `next`. Remember the channel here
+
+  public:
+    value_type storage{};
+
+  public:
+    explicit channel_select_reader(channel_type& ch) noexcept(false)
+        : reader{ch}, owner{ch} {
+    }
+
+  public:
+    mutex_type& mutex() noexcept {
+        return owner.mtx;
+    }
+    /**
+     * @return true  This reader is paired by the `internal::selection`
+     */
+    bool is_claimed(void* node) const noexcept {
+        return static_cast<const reader*>(this) == node;
+    }
+    /**
+     * @brief Take a value from the buffer or the waiting writer.
+     * @note  The channel must be **lock**ed. The lock is not released
+     * @return true  `storage` holds the value. The writer in `frame` must be resumed after **unlock**.
+     *               If the channel is closed, `frame` is the poison marker
+     */
+    bool try_take() noexcept(false) {
+        if (owner.buffer.is_empty() == false) {
+            storage = std::move(*owner.buffer.front());
+            this->frame = owner.pop_buffer();
+            return true;
+        }
+        if (owner.is_closed()) {
+            this->frame = internal::poison();
+            return true;
+        }
+        writer_list& writers = owner;
+        if (writers.is_empty())
+            return false;
+        writer* w = writers.pop();
+        storage = std::move(*w->ptr);
+        this->frame = w->frame;
+        w->frame = nullptr; // the writer has no partner to resume
+        return true;
+    }
+    /**
+     * @brief Push to the channel and wait for `channel_writer`.
+     * @note  The channel must be **lock**ed. The lock is not released
+     */
+    void enlist(coroutine_handle<void> coro, internal::selection& sel) noexcept(false) {
+        this->frame = coro.address();
+        this->next = nullptr;
+        this->group = std::addressof(sel);
+        reader_list& readers = owner;
+        readers.push(this);
+    }
+    /**
+     * @brief Remove from the channel if this reader is still waiting
+     */
+    void cancel() noexcept(false) {
+        std::unique_lock lck{owner.mtx};
+        reader_list& readers = owner;
+        readers.erase(this);
+    }
+    /**
+     * @brief Move the value from the paired writer and resume it
+     * @return false The channel is closed or under destruction
+     */
+    bool complete() noexcept(false) {
+        if (this->frame == internal::poison())
+            return false;
+        if (this->ptr) // paired after `enlist`
+            storage = std::move(*this->ptr);
+        owner.wake(this->frame);
+        return true;
+    }
+};
+
+/**
+ * @brief A pair of `channel` and function for `select_async`
+ * @ingroup channel
+ */
+template <typename T, typename M, typename Fn>
+class channel_select_case final {
+  public:
+    using channel_type = channel<T, M>;
+
+  public:
+    channel_select_reader<T, M> node;
+    Fn fn;
+
+  public:
+    template <typename F>
+    explicit channel_select_case(std::tuple<channel_type&, F&> arg) noexcept(false)
+        : node{std::get<0>(arg)}, fn{std::get<1>(arg)} {
+    }
+    channel_select_case(const channel_select_case&) = delete;
+    channel_select_case(channel_select_case&&) = delete;
+    channel_select_case& operator=(const channel_select_case&) = delete;
+    channel_select_case& operator=(channel_select_case&&) = delete;
+
+    /**
+     * @brief Invoke the function if the value is acquired
+     * @return false The channel is closed or under destruction
+     */
+    bool complete() noexcept(false) {
+        if (node.complete() == false)
+            return false;
+        fn(node.storage);
+        return true;
+    }
+};
+
+/**
+ * @brief Awaitable type for `select_async`.
+ *        Waits for multiple channels and resumes with the first paired one.
+ * @note  While checking/registering, it locks all channels with `std::lock`.
+ *        So the same channel must not be used twice in one `channel_select`.
+ *
+ * @see select_async
+ * @ingroup channel
+ */
+template <typename... Cases>
+class channel_select final {
+    static constexpr size_t npos = sizeof...(Cases);
+
+  private:
+    std::tuple<Cases...> cases;
+    internal::selection sel{};
+    size_t index = npos; /// Index of the paired case
+
+  private:
+    template <typename Tuple, size_t... I>
+    channel_select(Tuple&& args, std::index_sequence<I...>) noexcept(false)
+        : cases{std::forward_as_tuple(std::get<2 * I>(args),
+                                      std::get<2 * I + 1>(args))...} {
+    }
+
+    template <typename... Ls>
+    static void lock_all(Ls&... ls) noexcept(false) {
+        if constexpr (sizeof...(Ls) == 1)
+            (ls.lock(), ...);
+        else
+            std::lock(ls...); // deadlock avoidance
+    }
+
+  public:
+    template <typename... Args>
+    explicit channel_select(Args&&... args) noexcept(false)
+        : channel_select{std::forward_as_tuple(args...),
+                         std::make_index_sequence<npos>{}} {
+    }
+    channel_select(const channel_select&) = delete;
+    channel_select(channel_select&&) = delete;
+    channel_select& operator=(const channel_select&) = delete;
+    channel_select& operator=(channel_select&&) = delete;
+
+  public:
+    /**
+     * @brief Lock all channels and take a value from the first available one
+     *
+     * @return true   Acquired a value. All channels are **unlock**ed
+     * @return false  There was no available value.
+     *                All channels will be **lock**ed for this case.
+     */
+    bool await_ready() noexcept(false) {
+        std::apply([](auto&... c) { lock_all(c.node.mutex()...); }, cases);
+        size_t i = 0;
+        const bool taken = std::apply(
+            [&i](auto&... c) {
+                return ((c.node.try_take() || (++i, false)) || ...);
+            },
+            cases);
+        if (taken == false)
+            // await_suspend will unlock in the case
+            return false;
+        index = i;
+        std::apply([](auto&... c) { (c.node.mutex().unlock(), ...); }, cases);
+        return true;
+    }
+    /**
+     * @brief Push a reader to each channel and wait for the first writer.
+     * @note  All channels will be **unlock**ed after return.
+     */
+    void await_suspend(coroutine_handle<void> coro) noexcept(false) {
+        // the first unlock can resume this coroutine in the other thread.
+        // copy the mutexes to the stack before it
+        auto mtxs = std::apply(
+            [](auto&... c) { return std::make_tuple(&c.node.mutex()...); },
+            cases);
+        std::apply([this, coro](auto&... c) { (c.node.enlist(coro, sel), ...); },
+                   cases);
+        std::apply([](auto*... m) { (m->unlock(), ...); }, mtxs);
+    }
+    /**
+     * @brief Cancel other readers and invoke the function of the paired channel
+     *
+     * @return tuple<size_t, bool> Index of the paired channel and `bool` indicator for its destruction
+     */
+    auto await_resume() noexcept(false) -> std::tuple<size_t, bool> {
+        if (index == npos) {
+            void* winner = sel.get();
+            size_t i = 0;
+            std::apply(
+                [winner, &i](auto&... c) {
+                    ((c.node.is_claimed(winner) || (++i, false)) || ...);
+                },
+                cases);
+            index = i;
+            // the others are still in their channels
+            i = 0;
+            std::apply(
+                [this, &i](auto&... c) {
+                    ((i++ != index ? c.node.cancel() : void()), ...);
+                },
+                cases);
+        }
+        bool ok = false;
+        size_t i = 0;
+        std::apply(
+            [this, &i, &ok](auto&... c) {
+                ((i++ == index ? (void)(ok = c.complete()) : void()), ...);
+            },
+            cases);
+        return std::make_tuple(index, ok);
+    }
+};
+
+namespace internal {
+
+template <typename Select, typename... Args>
+struct make_select;
+
+template <typename... Cases>
+struct make_select<channel_select<Cases...>> {
+    using type = channel_select<Cases...>;
+};
+
+template <typename... Cases, typename T, typename M, typename Fn,
+          typename... Args>
+struct make_select<channel_select<Cases...>, channel<T, M>&, Fn, Args...> {
+    using type = typename make_select<
+        channel_select<Cases..., channel_select_case<T, M, std::decay_t<Fn>>>,
+        Args...>::type;
+};
+
+} // namespace internal
+
+/**
+ * @brief Wait for multiple channels. Unlike `select`, it suspends until one of them is paired.
+ * @note  Readers for the other channels are removed from their channels before the function invocation.
+ *
+ * @code
+ * auto [index, ok] = co_await select_async(
+ *     ch1, [](uint32_t v) { ... },
+ *     ch2, [](int32_t v) { ... });
+ * @endcode
+ *
+ * @param args pairs of `channel<T, M>&` and function to invoke with `T&`
+ * @return channel_select awaitable
+ * @see channel_select
+ * @ingroup channel
+ * @see test/channel_select_async.cpp
+ */
+template <typename... Args>
+auto select_async(Args&&... args) noexcept(false) {
+    static_assert(sizeof...(Args) % 2 == 0, "requires pairs of channel and function");
+    using select_type =
+        typename internal::make_select<channel_select<>, Args&...>::type;
+    return select_type{std::forward<Args>(args)...};
+}
+
 } // namespace coro
 
 #endif // LUNCLIFF_COROUTINE_CHANNEL_HPP
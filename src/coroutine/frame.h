@@ -80,6 +80,10 @@ struct coroutine_traits : public std::coroutine_traits<R, Args...> {
 #include <experimental/coroutine>
 
 #else
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::hash
+#include <type_traits>
 
 struct portable_coro_prefix;
 
@@ -269,6 +273,29 @@ struct coroutine_handle<noop_coroutine_promise>
         : coroutine_handle<void>{from_address(&this->promise())} {
         // A noop_coroutine_handle's ptr is always a non-null pointer
     }
+#elif defined(__GNUC__)
+    noop_coroutine_promise& promise() const noexcept {
+        return _Noop_frame._Prom;
+    }
+
+  private:
+    /**
+     * @brief GCC doesn't have `__builtin_coro_noop`.
+     *        Same with libstdc++, the frame's resume/destroy functions do nothing.
+     *        So the symmetric transfer to this handle returns to the resumer
+     */
+    struct _Noop_frame_t {
+        void (*_Factivate)(void*);
+        void (*_Fdestroy)(void*);
+        noop_coroutine_promise _Prom;
+    };
+    static void _Noop_procedure(void*) noexcept {
+    }
+    static inline _Noop_frame_t _Noop_frame{&_Noop_procedure, &_Noop_procedure, {}};
+
+    coroutine_handle() noexcept
+        : coroutine_handle<void>{from_address(&_Noop_frame)} {
+    }
 #endif
 
   private:
@@ -9,6 +9,15 @@
 #error "expect Linux platform for this file"
 #endif
 #include <sys/epoll.h> // for Linux epoll
+#if defined(COROUTINE_USE_IO_URING)
+#include <linux/io_uring.h> // for Linux io_uring
+#endif
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <coroutine/return.h>
 #include <gsl/gsl>
@@ -43,6 +52,13 @@ class epoll_owner final {
     epoll_owner& operator=(epoll_owner&&) = delete;
 
   public:
+    /**
+     * @return int64_t The epoll file descriptor. It can be bound to the other epoll
+     */
+    int64_t fd() const noexcept {
+        return epfd;
+    }
+
     /**
      * @brief bind the fd to epoll
      * @param fd
@@ -113,6 +129,122 @@ class epoll_owner final {
     }
 };
 
+#if defined(COROUTINE_USE_IO_URING)
+/**
+ * @brief RAII wrapping for io_uring instance without liburing
+ * @note  The submission is batched. `prepare` fills the SQ and `submit` flushes it.
+ *        The ring's fd is readable when CQ has entries. It can be bound to `epoll_owner`
+ * @see io_uring_setup
+ * @see io_uring_enter
+ * @ingroup Linux
+ */
+class io_uring_owner final {
+    int64_t ringfd;
+    uint32_t entries;
+    uint32_t pending; /// The number of SQEs which are not submitted
+    // mmap regions
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    io_uring_sqe* sqes;
+    // offsets in the mmap regions
+    io_sqring_offsets sq_off;
+    io_cqring_offsets cq_off;
+    std::mutex mtx;
+
+  public:
+    /**
+     * @brief create a ring with `io_uring_setup` and map its queues. Throw if the function fails.
+     * @param capacity The number of SQ entries
+     * @throw system_error
+     */
+    explicit io_uring_owner(uint32_t capacity = 256) noexcept(false);
+    /**
+     * @brief unmap the queues and close the ring's fd
+     */
+    ~io_uring_owner() noexcept;
+    io_uring_owner(const io_uring_owner&) = delete;
+    io_uring_owner(io_uring_owner&&) = delete;
+    io_uring_owner& operator=(const io_uring_owner&) = delete;
+    io_uring_owner& operator=(io_uring_owner&&) = delete;
+
+  private:
+    /**
+     * @brief Reserve an empty SQE. If the SQ is full, `submit` before the reservation
+     * @param count The number of SQEs which will be reserved without the `submit`
+     * @note  The `mtx` must be **lock**ed
+     * @throw system_error
+     */
+    io_uring_sqe* acquire(uint32_t count = 1) noexcept(false);
+    /**
+     * @brief Publish the SQE from the `acquire`
+     * @note  The `mtx` must be **lock**ed
+     */
+    void commit() noexcept;
+    uint32_t flush() noexcept(false);
+
+  public:
+    /**
+     * @return int64_t The io_uring file descriptor. It can be bound to the epoll
+     */
+    int64_t fd() const noexcept {
+        return ringfd;
+    }
+
+    /**
+     * @brief Fill an SQE with the given function. The SQE is not submitted until `submit`
+     * @param fill `void(io_uring_sqe&)`. The SQE is zero-filled before the invoke
+     * @throw system_error
+     *
+     * ```cpp
+     * ring.prepare([&](io_uring_sqe& sqe) {
+     *     sqe.opcode = IORING_OP_RECV;
+     *     sqe.fd = sd;
+     *     sqe.addr = reinterpret_cast<uint64_t>(buf.data());
+     *     sqe.len = buf.size_bytes();
+     *     sqe.user_data = reinterpret_cast<uint64_t>(&work);
+     * });
+     * ```
+     */
+    template <typename Fn>
+    void prepare(Fn&& fill) noexcept(false) {
+        std::unique_lock lck{mtx};
+        fill(*acquire());
+        commit();
+    }
+    /**
+     * @brief Fill 2 SQEs and link them with `IOSQE_IO_LINK`. They are submitted together
+     * @param next `void(io_uring_sqe&)`. `IORING_OP_LINK_TIMEOUT` for example
+     * @throw system_error
+     */
+    template <typename Fn1, typename Fn2>
+    void prepare(Fn1&& fill, Fn2&& next) noexcept(false) {
+        std::unique_lock lck{mtx};
+        auto* sqe = acquire(2);
+        fill(*sqe);
+        sqe->flags |= IOSQE_IO_LINK;
+        commit();
+        next(*acquire());
+        commit();
+    }
+
+    /**
+     * @brief Submit the prepared SQEs with `io_uring_enter`
+     * @return uint32_t The number of submitted SQEs
+     * @throw system_error
+     */
+    uint32_t submit() noexcept(false);
+
+    /**
+     * @brief Fetch the completions without wait
+     * @param list
+     * @return ptrdiff_t The number of fetched CQEs
+     */
+    ptrdiff_t reap(gsl::span<io_uring_cqe> list) noexcept;
+};
+#endif // COROUTINE_USE_IO_URING
+
 /**
  * @brief RAII + stateful `eventfd`
  * @see https://github.com/grpc/grpc/blob/master/src/core/lib/iomgr/is_epollexclusive_available.cc
@@ -149,7 +281,7 @@ class event final {
  * @return awaitable struct for the binding
  * @ingroup Linux
  */
-auto wait_in(epoll_owner& ep, event& efd) {
+inline auto wait_in(epoll_owner& ep, event& efd) {
     class awaiter : epoll_event {
         epoll_owner& ep;
         event& efd;
@@ -183,6 +315,194 @@ auto wait_in(epoll_owner& ep, event& efd) {
     return awaiter{ep, efd};
 }
 
+/**
+ * @brief Multi-threaded event loop. Each worker thread owns its epoll
+ * @note  The I/O awaitables in <coroutine/net.h> use the epoll of the worker
+ *        if the coroutine is running in the worker thread.
+ *        Otherwise, they use the global epoll for `poll_net_tasks`.
+ *
+ * ```cpp
+ * auto echo_service(io_context& ctx, int64_t sd) -> frame_t {
+ *     co_await ctx.schedule(); // move to a worker thread
+ *     // ... socket operations are polled by the worker ...
+ * }
+ *
+ * io_context ctx{4};
+ * std::thread t{[&ctx]() { ctx.run(); }};
+ * // ...
+ * ctx.stop();
+ * t.join();
+ * ```
+ * @ingroup Linux
+ */
+class io_context final {
+  public:
+    struct worker_t; // see io_linux.cpp
+
+  private:
+    std::vector<std::unique_ptr<worker_t>> workers;
+    std::atomic<bool> stopped;
+    std::atomic<uint32_t> next; /// Round-robin index for `post`
+
+  public:
+    /**
+     * @brief Create epoll for each worker. The threads are not started before `run`
+     * @param concurrency The number of worker threads. At least 1
+     * @param capacity The number of events for each direction in 1 `epoll_wait` of the worker
+     * @throw system_error
+     */
+    explicit io_context(uint32_t concurrency = std::thread::hardware_concurrency(),
+                        uint32_t capacity = 256) noexcept(false);
+    /**
+     * @brief `stop` the workers and close their epoll
+     * @note  The coroutines which are not resumed yet will be leaked
+     */
+    ~io_context() noexcept;
+    io_context(const io_context&) = delete;
+    io_context(io_context&&) = delete;
+    io_context& operator=(const io_context&) = delete;
+    io_context& operator=(io_context&&) = delete;
+
+  public:
+    uint32_t concurrency() const noexcept;
+
+    /**
+     * @brief Run the workers until `stop`. It can be called again after the return
+     * @note  The caller thread becomes the first worker.
+     *        The other workers are spawned and joined in this function.
+     *        If a worker throws, all workers are stopped and the first exception is rethrown
+     * @throw system_error, or the exception from the resumed coroutine
+     */
+    void run() noexcept(false);
+
+    /**
+     * @brief Request all workers to return from their loop. `run` will return after it
+     */
+    void stop() noexcept;
+
+    bool is_stopped() const noexcept;
+
+    /**
+     * @brief Resume the coroutine in one of the workers
+     * @note  If the caller is a worker of this context, the worker is selected
+     * @throw system_error
+     */
+    void post(coroutine_handle<void> coro) noexcept(false);
+
+    /**
+     * @brief `post` for the callback type of `channel::set_executor`
+     * @param ctx `io_context*`
+     */
+    static void execute(void* ctx, coroutine_handle<void> coro) noexcept(false) {
+        return reinterpret_cast<io_context*>(ctx)->post(coro);
+    }
+
+    /**
+     * @brief Move the coroutine to one of the workers
+     * @code
+     * co_await ctx.schedule();
+     * @endcode
+     */
+    [[nodiscard]] auto schedule() noexcept {
+        class awaiter final : public suspend_always {
+            io_context& ctx;
+
+          public:
+            explicit awaiter(io_context& _ctx) noexcept : ctx{_ctx} {
+            }
+            void await_suspend(coroutine_handle<void> coro) noexcept(false) {
+                return ctx.post(coro);
+            }
+        };
+        return awaiter{*this};
+    }
+};
+
+/**
+ * @brief Persistent edge-triggered registration of a socket
+ * @note  The socket is added to the epoll of the current thread's poller once.
+ *        While this object is alive, the awaitables in <coroutine/net.h> for the socket
+ *        park their coroutine in the slot of its direction instead of `epoll_ctl` for each operation.
+ *        1 operation for each direction at a time.
+ *        Destroy it in the poller's thread when there is no pending operation.
+ *        With `COROUTINE_USE_IO_URING`, the ring performs the operations and the epoll is not used
+ *
+ * ```cpp
+ * auto echo_service(int64_t sd) -> frame_t {
+ *     io_registration reg{sd}; // EPOLL_CTL_ADD
+ *     io_work_t work{};
+ *     while (true) {
+ *         // no more epoll_ctl
+ *         auto sz = co_await recv_stream(sd, buf, 0, work);
+ *         // ...
+ *     }
+ * } // EPOLL_CTL_DEL
+ * ```
+ * @ingroup Linux
+ */
+class io_registration final {
+  public:
+    /// @brief `nullptr`, the ready marker, or the address of the parked coroutine
+    using slot_type = std::atomic<void*>;
+
+  private:
+    int64_t sd;
+    epoll_owner* ep; /// The epoll which has the socket. `nullptr` for io_uring
+    slot_type inbound, outbound;
+
+  public:
+    /**
+     * @brief Make the socket non-blocking and add it to the epoll with `EPOLLET`
+     * @throw system_error
+     */
+    explicit io_registration(int64_t sd) noexcept(false);
+    /**
+     * @brief Remove the socket from the epoll. The socket is not closed
+     */
+    ~io_registration() noexcept;
+    io_registration(const io_registration&) = delete;
+    io_registration(io_registration&&) = delete;
+    io_registration& operator=(const io_registration&) = delete;
+    io_registration& operator=(io_registration&&) = delete;
+
+  public:
+    int64_t handle() const noexcept {
+        return sd;
+    }
+
+    /**
+     * @brief Find the registration of the socket
+     * @return io_registration* `nullptr` if the socket is not registered
+     */
+    static io_registration* find(int64_t sd) noexcept;
+
+    /**
+     * @brief Park the coroutine in the slot. It will be resumed with the next edge
+     * @param outbound `true` for `EPOLLOUT`. `false` for `EPOLLIN`
+     * @return false The socket became ready. The readiness is consumed
+     *               and the coroutine is not parked
+     */
+    bool park(bool outbound, coroutine_handle<void> coro) noexcept;
+
+    /**
+     * @brief Mark the slot ready again after the `park` returned `false`
+     * @note  The operation was not blocked. The socket may be still ready
+     */
+    void keep(bool outbound) noexcept;
+
+    /**
+     * @brief Take the parked coroutine out of the slot for the timeout of its operation
+     * @return false The coroutine is not parked. `notify` took(or will take) it
+     */
+    bool cancel(bool outbound, coroutine_handle<void> coro) noexcept;
+
+    /**
+     * @brief Mark the slots ready with `epoll_event::events` and resume the parked coroutines
+     * @return ptrdiff_t The number of the resumed coroutines
+     */
+    ptrdiff_t notify(uint32_t events) noexcept(false);
+};
+
 } // namespace coro
 
 #endif // COROUTINE_SYSTEM_WRAPPER_H
@@ -7,6 +7,8 @@
 #pragma once
 #ifndef COROUTINE_NET_IO_H
 #define COROUTINE_NET_IO_H
+#include <atomic>
+#include <chrono>
 #include <gsl/gsl>
 
 #include <coroutine/return.h>
@@ -55,7 +57,7 @@ struct io_control_block {
         };
         void* ptr; // sockaddr* addr;
     };
-    int64_t handle; // int64_t sd;
+    int64_t handle; // int32_t sd, uint32_t state
 };
 
 #endif // winsock || netinet
@@ -81,11 +83,14 @@ class io_work_t : public io_control_block {
 
   protected:
     /**
+     * @brief Try the operation once before the suspension. For the blocking socket, it blocks
+     * @note  The blocking mode of the socket is cached in the work for the same socket.
+     *        `io_registration` and `EAGAIN` from the blocking path refresh it
      * @see await_ready
-     * @return true  The given socket can be use for non-blocking operations
-     * @return false For Windows, the return is always `false`
+     * @return true  The operation is done
+     * @return false `EAGAIN`. For Windows, the return is always `false`
      */
-    bool ready() const noexcept;
+    bool ready() noexcept;
 
   public:
     /**
@@ -106,9 +111,10 @@ class io_send_to final : public io_work_t {
   private:
     /**
      * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
      * @throw std::system_error
      */
-    void suspend(coroutine_handle<void> t) noexcept(false);
+    bool suspend(coroutine_handle<void> t) noexcept(false);
     /**
      * @brief Fetch I/O result/error
      * @return int64_t return of `sendto`
@@ -119,13 +125,13 @@ class io_send_to final : public io_work_t {
     int64_t resume() noexcept;
 
   public:
-    bool await_ready() const noexcept {
+    bool await_ready() noexcept {
         return this->ready();
     }
     /**
      * @throw std::system_error
      */
-    void await_suspend(coroutine_handle<void> t) noexcept(false) {
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
         return this->suspend(t);
     }
     int64_t await_resume() noexcept {
@@ -144,9 +150,10 @@ class io_recv_from final : public io_work_t {
   private:
     /**
      * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
      * @throw std::system_error
      */
-    void suspend(coroutine_handle<void> t) noexcept(false);
+    bool suspend(coroutine_handle<void> t) noexcept(false);
     /**
      * @brief Fetch I/O result/error
      * @return int64_t return of `recvfrom`
@@ -157,13 +164,13 @@ class io_recv_from final : public io_work_t {
     int64_t resume() noexcept;
 
   public:
-    bool await_ready() const noexcept {
+    bool await_ready() noexcept {
         return this->ready();
     }
     /**
      * @throw std::system_error
      */
-    void await_suspend(coroutine_handle<void> t) noexcept(false) {
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
         return this->suspend(t);
     }
     int64_t await_resume() noexcept {
@@ -182,9 +189,10 @@ class io_send final : public io_work_t {
   private:
     /**
      * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
      * @throw std::system_error
      */
-    void suspend(coroutine_handle<void> t) noexcept(false);
+    bool suspend(coroutine_handle<void> t) noexcept(false);
     /**
      * @brief Fetch I/O result/error
      * @return int64_t return of `send`
@@ -195,10 +203,10 @@ class io_send final : public io_work_t {
     int64_t resume() noexcept;
 
   public:
-    bool await_ready() const noexcept {
+    bool await_ready() noexcept {
         return this->ready();
     }
-    void await_suspend(coroutine_handle<void> t) noexcept(false) {
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
         return this->suspend(t);
     }
     int64_t await_resume() noexcept {
@@ -217,9 +225,10 @@ class io_recv final : public io_work_t {
   private:
     /**
      * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
      * @throw std::system_error
      */
-    void suspend(coroutine_handle<void> t) noexcept(false);
+    bool suspend(coroutine_handle<void> t) noexcept(false);
 
     /**
      * @brief Fetch I/O result/error
@@ -231,10 +240,10 @@ class io_recv final : public io_work_t {
     int64_t resume() noexcept;
 
   public:
-    bool await_ready() const noexcept {
+    bool await_ready() noexcept {
         return this->ready();
     }
-    void await_suspend(coroutine_handle<void> t) noexcept(false) {
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
         return this->suspend(t);
     }
     int64_t await_resume() noexcept {
@@ -243,6 +252,420 @@ class io_recv final : public io_work_t {
 };
 static_assert(sizeof(io_recv) == sizeof(io_work_t));
 
+#if defined(__linux__)
+/**
+ * @brief Awaitable type to perform `sendmsg` I/O request with the scatter/gather buffers
+ * @see sendmsg
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_send_msg final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t return of `sendmsg`. The number of sent bytes
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_send_msg) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to perform `recvmsg` I/O request with the scatter/gather buffers
+ * @see recvmsg
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_recv_msg final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t return of `recvmsg`. The number of received bytes
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_recv_msg) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to perform `sendmmsg` I/O request. Multiple datagrams for 1 resume
+ * @see sendmmsg
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_send_mmsg final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t return of `sendmmsg`. The number of sent messages
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_send_mmsg) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to perform `recvmmsg` I/O request. Multiple datagrams for 1 resume
+ * @see recvmmsg
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_recv_mmsg final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t return of `recvmmsg`. The number of received messages
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_recv_mmsg) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to perform `accept4` I/O request. The accepted sockets are non-blocking
+ * @see accept4
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_accept final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t The accepted socket. Or the number of the accepted sockets for `accept_streams`. `-1` if failed
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_accept) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to perform `connect` I/O request
+ * @see connect
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_connect final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t 0 if connected. `-1` if failed
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_connect) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to perform `sendfile` I/O request.
+ *        The file is sent without the copy to the user buffer
+ * @see sendfile
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_send_file final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t return of `sendfile`. The offset is moved forward
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_send_file) == sizeof(io_work_t));
+
+/**
+ * @brief Awaitable type to receive the completion of `MSG_ZEROCOPY` sends from the error queue.
+ *        The buffers of the completed sends can be reused
+ * @see https://www.kernel.org/doc/html/latest/networking/msg_zerocopy.html
+ * @note Linux only. The socket must have `SO_ZEROCOPY`
+ * @ingroup Network
+ */
+class io_recv_zerocopy final : public io_work_t {
+  private:
+    /**
+     * @brief makes an I/O request with given context(`coroutine_handle<void>`)
+     * @return false The request is done without suspension. see `io_registration`
+     * @throw std::system_error
+     */
+    bool suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @brief Fetch I/O result/error
+     * @return int64_t The number of the completed sends of the socket. `-1` if failed
+     * 
+     * This function must be used through `co_await`.
+     * Multiple invoke of this will lead to malfunction.
+     */
+    int64_t resume() noexcept;
+
+  public:
+    bool await_ready() noexcept {
+        return this->ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        return this->suspend(t);
+    }
+    int64_t await_resume() noexcept {
+        return this->resume();
+    }
+};
+static_assert(sizeof(io_recv_zerocopy) == sizeof(io_work_t));
+
+/**
+ * @brief The deadline of 1 suspended operation. see `with_timeout`
+ * @note  The poller which suspended the operation handles the deadline with `timerfd`.
+ *        With io_uring, `IORING_OP_LINK_TIMEOUT` is linked to the operation instead.
+ *        The blocking socket doesn't suspend. Use `socket_set_option_recv_timout` for it
+ * @note  The operation waits with the `handle()`, not the coroutine.
+ *        The I/O and the timer `claim` it before the resume. Only the first one resumes
+ * @note Linux only
+ * @ingroup Network
+ */
+class io_deadline_t final {
+    friend struct io_poller_t;
+
+  public:
+    /// @brief Tag of the `handle()`. The coroutine frames are aligned
+    static constexpr uintptr_t tag = 2;
+    enum state_t : uint32_t {
+        arming = 1, /// `await_suspend` is still using the deadline
+        claimed_by_io = 2,
+        claimed_by_timer = 4,
+    };
+
+  private:
+    io_work_t& work;
+    std::chrono::nanoseconds timeout;
+    coroutine_handle<void> task{};
+    void* poller = nullptr; /// The poller of the `prepare`
+    int64_t expiry = 0;     /// `CLOCK_MONOTONIC` in nanoseconds
+    int64_t spec[2]{};      /// `__kernel_timespec` of the `expiry` for io_uring
+    std::atomic<uint32_t> state{0};
+
+  public:
+    io_deadline_t(io_work_t& _work, std::chrono::nanoseconds _timeout) noexcept
+        : work{_work}, timeout{_timeout} {
+    }
+    io_deadline_t(const io_deadline_t&) = delete;
+    io_deadline_t(io_deadline_t&&) = delete;
+    io_deadline_t& operator=(const io_deadline_t&) = delete;
+    io_deadline_t& operator=(io_deadline_t&&) = delete;
+
+  private:
+    /**
+     * @return uint32_t The previous state.
+     *                  The caller resumes the coroutine if there was no claim and no `arming`
+     */
+    uint32_t claim(state_t by) noexcept;
+
+  public:
+    /**
+     * @brief Start `arming` before the suspension of the operation
+     * @throw std::system_error
+     */
+    void prepare(coroutine_handle<void> coro) noexcept(false);
+    /// @brief The operation must wait with this instead of the coroutine
+    coroutine_handle<void> handle() noexcept {
+        return coroutine_handle<void>::from_address(
+            reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(this) | tag));
+    }
+    /**
+     * @brief Schedule the deadline after the operation is suspended
+     * @note  The program terminates if the deadline can't be scheduled.
+     *        The operation is already waiting. It can't be rolled back
+     * @return false The operation is already done(or expired). Resume the coroutine now
+     */
+    bool arm() noexcept;
+    /**
+     * @brief Remove the deadline from the poller
+     * @return true The deadline is expired and the operation is cancelled.
+     *              The error of the work is `ETIMEDOUT`
+     */
+    bool disarm() noexcept;
+
+    /// @return io_deadline_t* `nullptr` if the handle is not from the `handle()`
+    static io_deadline_t* from(coroutine_handle<void> h) noexcept {
+        const auto addr = reinterpret_cast<uintptr_t>(h.address());
+        if ((addr & tag) == 0)
+            return nullptr;
+        return reinterpret_cast<io_deadline_t*>(addr & ~tag);
+    }
+    /**
+     * @brief Resume the handle for the I/O. The deadline is claimed before the resume
+     * @return false The handle is from the `handle()` and the timer(or `arm`) will resume it
+     */
+    static bool resume(coroutine_handle<void> h) noexcept(false);
+};
+
+/**
+ * @brief Awaitable wrapper which cancels the operation after the timeout
+ * @tparam T `io_recv`, `io_send` and the other awaitables in this file
+ * @see with_timeout
+ * @note Linux only
+ * @ingroup Network
+ */
+template <typename T>
+class io_timeout_t final {
+    T& op;
+    io_deadline_t deadline;
+
+  public:
+    io_timeout_t(T& _op, std::chrono::nanoseconds timeout) noexcept
+        : op{_op}, deadline{_op, timeout} {
+    }
+
+  public:
+    bool await_ready() noexcept {
+        return op.await_ready();
+    }
+    bool await_suspend(coroutine_handle<void> t) noexcept(false) {
+        deadline.prepare(t);
+        if (op.await_suspend(deadline.handle()) == false)
+            return false;
+        // the operation can be done in the other thread before this
+        return deadline.arm();
+    }
+    int64_t await_resume() noexcept {
+        if (deadline.disarm())
+            return -1;
+        return op.await_resume();
+    }
+};
+
+#endif // __linux__
+
 /**
  * @brief Constructs `io_send_to` awaitable with the given parameters
  * @param sd 
@@ -302,6 +725,8 @@ auto recv_from(uint64_t sd, sockaddr_in6& remote, io_buffer_t buf,
  * @param flag 
  * @param work 
  * @return io_send&
+ * @note  For Linux, `MSG_ZEROCOPY` is available for the flag.
+ *        The buffer must be kept until `recv_zerocopy` reports the completion
  *  
  * @ingroup Network
  */
@@ -321,14 +746,193 @@ auto send_stream(uint64_t sd, io_buffer_t buf, uint32_t flag,
 auto recv_stream(uint64_t sd, io_buffer_t buf, uint32_t flag,
                  io_work_t& work) noexcept(false) -> io_recv&;
 
+#if defined(__linux__)
+/**
+ * @brief Constructs `io_send_msg` awaitable with the given parameters
+ * @param sd 
+ * @param msg `msg_name` for the remote(can be `nullptr`). `msg_iov` for the buffers.
+ *            It must be alive until the `co_await` returns
+ * @param flag 
+ * @param work 
+ * @return io_send_msg& 
+ * 
+ * @ingroup Network
+ */
+auto send_msg(uint64_t sd, const msghdr& msg, uint32_t flag,
+              io_work_t& work) noexcept(false) -> io_send_msg&;
+
+/**
+ * @brief Constructs `io_recv_msg` awaitable with the given parameters
+ * @param sd 
+ * @param msg `msg_name` receives the remote(can be `nullptr`). `msg_iov` for the buffers.
+ *            It must be alive until the `co_await` returns
+ * @param flag 
+ * @param work 
+ * @return io_recv_msg& 
+ * 
+ * @ingroup Network
+ */
+auto recv_msg(uint64_t sd, msghdr& msg, uint32_t flag,
+              io_work_t& work) noexcept(false) -> io_recv_msg&;
+
+/**
+ * @brief Constructs `io_send_mmsg` awaitable with the given parameters
+ * @param sd 
+ * @param msgs Each `msg_len` will be the number of sent bytes
+ * @param flag 
+ * @param work 
+ * @return io_send_mmsg& 
+ * 
+ * @ingroup Network
+ */
+auto send_mmsg(uint64_t sd, gsl::span<mmsghdr> msgs, uint32_t flag,
+               io_work_t& work) noexcept(false) -> io_send_mmsg&;
+
+/**
+ * @brief Constructs `io_recv_mmsg` awaitable with the given parameters
+ * @param sd 
+ * @param msgs Each `msg_len` will be the number of received bytes.
+ *             Each `msg_hdr.msg_namelen` must be the size of its `msg_name`
+ * @param flag For the blocking socket, `MSG_WAITFORONE` will be helpful
+ * @param work 
+ * @return io_recv_mmsg& 
+ * 
+ * @ingroup Network
+ */
+auto recv_mmsg(uint64_t sd, gsl::span<mmsghdr> msgs, uint32_t flag,
+               io_work_t& work) noexcept(false) -> io_recv_mmsg&;
+
+/**
+ * @brief Constructs `io_accept` awaitable with the given parameters
+ * @param ln The listening socket
+ * @param remote The address of the accepted socket
+ * @param work 
+ * @return io_accept& The result is the accepted socket
+ * 
+ * @ingroup Network
+ */
+auto accept_stream(uint64_t ln, sockaddr_in& remote,
+                   io_work_t& work) noexcept(false) -> io_accept&;
+
+/**
+ * @brief Constructs `io_accept` awaitable with the given parameters
+ * @param ln The listening socket
+ * @param remote The address of the accepted socket
+ * @param work 
+ * @return io_accept& The result is the accepted socket
+ * 
+ * @ingroup Network
+ */
+auto accept_stream(uint64_t ln, sockaddr_in6& remote,
+                   io_work_t& work) noexcept(false) -> io_accept&;
+
+/**
+ * @brief Constructs `io_accept` awaitable which drains the backlog for 1 resume
+ * @param ln The listening socket
+ * @param sds The accepted sockets. If `ln` is blocking, only 1 will be accepted
+ * @param work 
+ * @return io_accept& The result is the number of the accepted sockets
+ * 
+ * @ingroup Network
+ */
+auto accept_streams(uint64_t ln, gsl::span<int64_t> sds,
+                    io_work_t& work) noexcept(false) -> io_accept&;
+
+/**
+ * @brief Constructs `io_connect` awaitable with the given parameters
+ * @param sd 
+ * @param remote 
+ * @param work 
+ * @return io_connect& 
+ * 
+ * @ingroup Network
+ */
+auto connect_stream(uint64_t sd, const sockaddr_in& remote,
+                    io_work_t& work) noexcept(false) -> io_connect&;
+
+/**
+ * @brief Constructs `io_connect` awaitable with the given parameters
+ * @param sd 
+ * @param remote 
+ * @param work 
+ * @return io_connect& 
+ * 
+ * @ingroup Network
+ */
+auto connect_stream(uint64_t sd, const sockaddr_in6& remote,
+                    io_work_t& work) noexcept(false) -> io_connect&;
+
+/**
+ * @brief Constructs `io_send_file` awaitable with the given parameters
+ * @param sd 
+ * @param fd The file to send
+ * @param offset The position in the file. Updated after the send
+ * @param count The maximum number of bytes to send
+ * @param work 
+ * @return io_send_file& 
+ * 
+ * @ingroup Network
+ */
+auto send_file(uint64_t sd, int64_t fd, int64_t& offset, size_t count,
+               io_work_t& work) noexcept(false) -> io_send_file&;
+
+/**
+ * @brief Constructs `io_recv_zerocopy` awaitable with the given parameters
+ * @param sd The socket which sent with `MSG_ZEROCOPY`
+ * @param work 
+ * @return io_recv_zerocopy& The result is the number of the completed sends
+ * @note  The sends of the socket are counted from 0 by the kernel.
+ *        With 1 awaiter for each direction of the socket,
+ *        wait for the completion in the same coroutine which sends
+ * 
+ * @ingroup Network
+ */
+auto recv_zerocopy(uint64_t sd, io_work_t& work) noexcept(false)
+    -> io_recv_zerocopy&;
+
 /**
- * @brief Poll internal I/O works and invoke user callback
+ * @brief Apply the timeout to the awaitable. The socket must be non-blocking
+ * @param op The awaitable from `recv_stream`, `send_stream`, ...
+ * @param timeout 
+ * @return io_timeout_t<T> The result is `-1` with `ETIMEDOUT` if the operation is not done in time
+ * 
+ * ```cpp
+ * auto sz = co_await with_timeout(recv_stream(sd, buf, 0, work), 500ms);
+ * if (sz < 0 && work.error() == ETIMEDOUT)
+ *     // ...
+ * ```
+ * 
+ * @ingroup Network
+ */
+template <typename T>
+auto with_timeout(T& op, std::chrono::nanoseconds timeout) noexcept
+    -> io_timeout_t<T> {
+    return {op, timeout};
+}
+#endif // __linux__
+
+/**
+ * @brief Poll internal I/O works and resume their coroutines
+ * @note  For Linux, the concurrent callers wait for each other. The deadlines of `with_timeout` rely on it.
+ *        So the resumed coroutines must not invoke this again.
+ *        For the others, the callers can poll together with their own event buffers
  * @param nano timeout in nanoseconds 
+ * @return ptrdiff_t The number of the resumed coroutines
  * @throw std::system_error
  * 
  * @ingroup Network
  */
-void poll_net_tasks(uint64_t nano) noexcept(false);
+ptrdiff_t poll_net_tasks(uint64_t nano) noexcept(false);
+
+/**
+ * @brief Change the maximum number of events in 1 `poll_net_tasks`
+ * @param count The default is 256. For Windows, this does nothing
+ * @note  The event buffer is persistent. It is reallocated in the next `poll_net_tasks`
+ *        For Darwin, each polling thread has its own buffer
+ * 
+ * @ingroup Network
+ */
+void set_net_poll_capacity(uint32_t count) noexcept(false);
 
 /**
  * @brief Thin wrapper of `getaddrinfo` for IPv4
@@ -364,6 +968,181 @@ uint32_t get_address(const addrinfo& hint, //
                      gsl::czstring host, gsl::czstring serv,
                      gsl::span<sockaddr_in6> output) noexcept;
 
+/**
+ * @brief `get_address` with the process-wide resolver cache
+ * @note  The key is (host, serv, family, socktype, protocol, flags) of the request.
+ *        Up to 8 addresses are kept for each entry. The failure is also cached(negative entry)
+ *        except the temporary ones like `EAI_AGAIN`
+ * @see set_resolver_cache_ttl
+ * 
+ * @param hint 
+ * @param host 
+ * @param serv 
+ * @param output
+ * @return uint32_t Error code from the `getaddrinfo`. It can be from the cache
+ * 
+ * @ingroup Network
+ */
+uint32_t get_address_cached(const addrinfo& hint, //
+                            gsl::czstring host, gsl::czstring serv,
+                            gsl::span<sockaddr_in> output) noexcept;
+
+/**
+ * @brief `get_address` with the process-wide resolver cache
+ * @see get_address_cached
+ * 
+ * @param hint 
+ * @param host 
+ * @param serv 
+ * @param output
+ * @return uint32_t Error code from the `getaddrinfo`. It can be from the cache
+ * 
+ * @ingroup Network
+ */
+uint32_t get_address_cached(const addrinfo& hint, //
+                            gsl::czstring host, gsl::czstring serv,
+                            gsl::span<sockaddr_in6> output) noexcept;
+
+/**
+ * @brief Change the lifetime of the new entries in the resolver cache.
+ *        `getaddrinfo` doesn't report the TTL of the DNS record
+ * @param positive The default is 30 seconds. `0` disables the cache
+ * @param negative For the failed resolution. The default is 5 seconds
+ * 
+ * @ingroup Network
+ */
+void set_resolver_cache_ttl(std::chrono::seconds positive,
+                            std::chrono::seconds negative) noexcept;
+
+/**
+ * @brief Remove all entries in the resolver cache. The counters are not reset
+ * @ingroup Network
+ */
+void clear_resolver_cache() noexcept;
+
+/**
+ * @brief Counters of the resolver cache
+ * @ingroup Network
+ */
+struct resolver_cache_stats_t final {
+    uint64_t hit;
+    uint64_t miss;     /// Including the expired entries
+    uint64_t eviction; /// The live entries replaced by the others
+};
+
+/**
+ * @brief Load the counters of the resolver cache
+ * @ingroup Network
+ */
+auto get_resolver_cache_stats() noexcept -> resolver_cache_stats_t;
+
+/**
+ * @brief Awaitable type to perform `get_address_cached` in the resolver threads
+ * @note  The resolver threads are spawned on demand. Up to `max_concurrency`.
+ *        Without the executor, the coroutine is resumed in the resolver thread
+ * @see resolve_address
+ * @ingroup Network
+ */
+class io_resolve_t final {
+  public:
+    /// @brief Same with the executor of `channel`. `io_context::execute` can be used
+    using executor_type = void (*)(void* context, coroutine_handle<void> coro);
+    static constexpr uint32_t max_concurrency = 4;
+
+  private:
+    const addrinfo& hint;
+    gsl::czstring host;
+    gsl::czstring serv;
+    gsl::span<sockaddr_in> output4;
+    gsl::span<sockaddr_in6> output6;
+    executor_type executor;
+    void* context;
+    coroutine_handle<void> task{};
+    uint32_t ec = 0;
+
+  public:
+    io_resolve_t(const addrinfo& hint, gsl::czstring host, gsl::czstring serv,
+                 gsl::span<sockaddr_in> output, executor_type fn,
+                 void* ctx) noexcept;
+    io_resolve_t(const addrinfo& hint, gsl::czstring host, gsl::czstring serv,
+                 gsl::span<sockaddr_in6> output, executor_type fn,
+                 void* ctx) noexcept;
+    io_resolve_t(const io_resolve_t&) = delete;
+    io_resolve_t(io_resolve_t&&) = delete;
+    io_resolve_t& operator=(const io_resolve_t&) = delete;
+    io_resolve_t& operator=(io_resolve_t&&) = delete;
+
+    /**
+     * @brief Invoke `get_address` and resume the coroutine(or post it to the executor)
+     * @note  The resolver thread uses this
+     */
+    void resolve() noexcept(false);
+
+  public:
+    /**
+     * @brief The numeric host(`AI_NUMERICHOST`) or the passive one(`nullptr`) doesn't require the DNS.
+     *        They and the entries in the resolver cache are resolved without the suspension
+     * @see get_address_cached
+     */
+    bool await_ready() noexcept;
+    /**
+     * @brief Push the request to the queue of the resolver threads
+     * @throw std::system_error failed to spawn the thread
+     */
+    void await_suspend(coroutine_handle<void> t) noexcept(false);
+    /**
+     * @return uint32_t Error code from the `getaddrinfo`. see `get_address_cached`
+     */
+    uint32_t await_resume() noexcept {
+        return ec;
+    }
+};
+
+/**
+ * @brief Constructs `io_resolve_t` awaitable. `getaddrinfo` won't block the current thread
+ * 
+ * @param hint 
+ * @param host 
+ * @param serv 
+ * @param output
+ * @param fn The executor to resume the coroutine. `nullptr` to resume in the resolver thread
+ * @param ctx The context of the executor
+ * @return io_resolve_t The result is same with `get_address_cached`
+ * 
+ * ```cpp
+ * array<sockaddr_in6, 4> addrs{};
+ * if (auto ec = co_await resolve_address(hint, "example.com", "https", addrs,
+ *                                        io_context::execute, &ctx))
+ *     fputs(gai_strerror(ec), stderr);
+ * ```
+ * 
+ * @ingroup Network
+ */
+auto resolve_address(const addrinfo& hint, //
+                     gsl::czstring host, gsl::czstring serv,
+                     gsl::span<sockaddr_in> output,
+                     io_resolve_t::executor_type fn = nullptr,
+                     void* ctx = nullptr) noexcept -> io_resolve_t;
+
+/**
+ * @brief Constructs `io_resolve_t` awaitable. `getaddrinfo` won't block the current thread
+ * 
+ * @param hint 
+ * @param host 
+ * @param serv 
+ * @param output
+ * @param fn The executor to resume the coroutine. `nullptr` to resume in the resolver thread
+ * @param ctx The context of the executor
+ * @return io_resolve_t The result is same with `get_address_cached`
+ * 
+ * @ingroup Network
+ */
+auto resolve_address(const addrinfo& hint, //
+                     gsl::czstring host, gsl::czstring serv,
+                     gsl::span<sockaddr_in6> output,
+                     io_resolve_t::executor_type fn = nullptr,
+                     void* ctx = nullptr) noexcept -> io_resolve_t;
+
 /**
  * @brief Thin wrapper of `getnameinfo`
  * 
@@ -15,6 +15,7 @@
 
 namespace coro {
 using std::coroutine_handle;
+using std::noop_coroutine;
 using std::suspend_always;
 using std::suspend_never;
 
@@ -23,6 +24,7 @@ using std::suspend_never;
 
 namespace coro {
 using std::experimental::coroutine_handle;
+using std::experimental::noop_coroutine;
 using std::experimental::suspend_always;
 using std::experimental::suspend_never;
 
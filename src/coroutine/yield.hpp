@@ -1,19 +1,315 @@
 ﻿/**
  * @file coroutine/yield.hpp
  * @author github.com/luncliff (luncliff@gmail.com)
- * @brief `enumerable` is simply a copy of `generator` in VC++
+ * @brief `enumerable` is simply a copy of `generator` in VC++.
+ *        `async_enumerable` is for the producer which uses `co_await`.
+ *        The adaptors(`transform`, `filter`, `take`, `chunk`, `zip`) are for the pipeline
  * @copyright CC BY 4.0
  */
 #ifndef COROUTINE_YIELD_HPP
 #define COROUTINE_YIELD_HPP
+#include <array>
+#include <cstddef>
+#include <exception>
 #include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <coroutine/return.h>
 
 namespace coro {
 
+/**
+ * @brief Thread-local free list for the coroutine frames. see `promise_alloc`
+ * @note  The blocks are grouped with 64 byte unit up to 2 KB.
+ *        The larger ones are not recycled.
+ *        The frames which are destroyed after the recycler(in the other `thread_local`'s destructor)
+ *        use the global `operator new`/`delete`
+ */
+class frame_recycler final {
+  public:
+    static constexpr size_t unit = 64;
+    static constexpr size_t class_count = 32;
+    static constexpr size_t depth = 8; /// The number of blocks for each size
+
+  private:
+    struct list_t final {
+        std::array<void*, depth> blocks{};
+        size_t count = 0;
+    };
+    std::array<list_t, class_count> lists{};
+    bool* destroyed; // trivially destructible flag. it outlives the recycler
+
+  public:
+    explicit frame_recycler(bool* flag) noexcept : destroyed{flag} {
+    }
+    frame_recycler(const frame_recycler&) = delete;
+    frame_recycler& operator=(const frame_recycler&) = delete;
+    ~frame_recycler() noexcept {
+        *destroyed = true;
+        for (auto& list : lists)
+            while (list.count)
+                ::operator delete(list.blocks[--list.count]);
+    }
+
+    /**
+     * @brief The recycler of the current thread
+     * @return frame_recycler* `nullptr` if it is already destroyed in the thread's exit
+     */
+    static frame_recycler* current() noexcept {
+        static thread_local bool destroyed = false;
+        if (destroyed)
+            return nullptr;
+        static thread_local frame_recycler recycler{&destroyed};
+        return &recycler;
+    }
+
+    /// @throw std::bad_alloc
+    void* allocate(size_t size) noexcept(false) {
+        const auto index = (size + unit - 1) / unit - 1;
+        if (index >= class_count)
+            return ::operator new(size);
+        auto& list = lists[index];
+        if (list.count)
+            return list.blocks[--list.count];
+        return ::operator new((index + 1) * unit);
+    }
+    /// @param size Same with the `allocate`. The block can be from the other thread
+    void deallocate(void* ptr, size_t size) noexcept {
+        const auto index = (size + unit - 1) / unit - 1;
+        if (index >= class_count || lists[index].count == depth)
+            return ::operator delete(ptr);
+        auto& list = lists[index];
+        list.blocks[list.count++] = ptr;
+    }
+};
+
+/**
+ * @brief Allocation functions for the coroutine frame.
+ *        Inherit this in the `promise_type`
+ * @note  Without `std::allocator_arg_t`, the frame is from the `frame_recycler` of the thread
+ * @see frame_recycler
+ */
+class promise_alloc {
+    /**
+     * @brief Deallocation function for the frame. Stored after the frame
+     * @details `[frame][deallocate_fn][allocator]`
+     */
+    using deallocate_fn = void (*)(void* frame, size_t size) noexcept;
+    using block_t = std::aligned_storage_t<__STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                                           __STDCPP_DEFAULT_NEW_ALIGNMENT__>;
+
+    static constexpr size_t round_up(size_t size, size_t align) noexcept {
+        return (size + align - 1) / align * align;
+    }
+    static constexpr size_t fn_offset(size_t size) noexcept {
+        return round_up(size, alignof(deallocate_fn));
+    }
+    template <typename Alloc>
+    static constexpr size_t allocator_offset(size_t size) noexcept {
+        return round_up(fn_offset(size) + sizeof(deallocate_fn), alignof(Alloc));
+    }
+    template <typename Alloc>
+    static constexpr size_t block_count(size_t size) noexcept {
+        return round_up(allocator_offset<Alloc>(size) + sizeof(Alloc),
+                        sizeof(block_t)) /
+               sizeof(block_t);
+    }
+
+    static void* bind(void* frame, size_t size, deallocate_fn fn) noexcept {
+        ::new (static_cast<std::byte*>(frame) + fn_offset(size)) deallocate_fn{fn};
+        return frame;
+    }
+    static void recycle(void* frame, size_t size) noexcept {
+        if (auto recycler = frame_recycler::current())
+            return recycler->deallocate(frame, fn_offset(size) + sizeof(deallocate_fn));
+        return ::operator delete(frame);
+    }
+    template <typename Alloc>
+    static void* acquire(size_t size, const void* ptr) noexcept(false) {
+        using block_allocator = typename std::allocator_traits<
+            Alloc>::template rebind_alloc<block_t>;
+        const auto& alloc = *static_cast<const Alloc*>(ptr);
+        block_allocator blocks{alloc};
+        void* frame = std::allocator_traits<block_allocator>::allocate(
+            blocks, block_count<Alloc>(size));
+        ::new (static_cast<std::byte*>(frame) + allocator_offset<Alloc>(size))
+            Alloc{alloc};
+        return bind(frame, size, &release<Alloc>);
+    }
+    template <typename Alloc>
+    static void release(void* frame, size_t size) noexcept {
+        using block_allocator = typename std::allocator_traits<
+            Alloc>::template rebind_alloc<block_t>;
+        auto stored = reinterpret_cast<Alloc*>(static_cast<std::byte*>(frame) +
+                                               allocator_offset<Alloc>(size));
+        block_allocator alloc{std::move(*stored)};
+        stored->~Alloc();
+        std::allocator_traits<block_allocator>::deallocate(
+            alloc, static_cast<block_t*>(frame), block_count<Alloc>(size));
+    }
+
+    /**
+     * @brief `std::allocator_arg_t` in the arguments, but none of the `operator new` below fits
+     * @details The first one is the object for the member function
+     */
+    template <typename... Args>
+    static constexpr bool unsupported_args() noexcept {
+        constexpr size_t count = sizeof...(Args);
+        constexpr bool tags[] = {
+            std::is_same_v<std::decay_t<Args>, std::allocator_arg_t>..., false};
+        if (tags[0])
+            return count < 2 || count > 6;
+        if (count > 1 && tags[1])
+            return count < 3 || count > 7;
+        for (size_t i = 2; i < count; ++i)
+            if (tags[i])
+                return true;
+        return false;
+    }
+
+  public:
+    /**
+     * @brief The allocator in the arguments of the coroutine
+     * @note  The `operator new`s are not templates, so GCC can pair them
+     *        with the `operator delete`(`-Wmismatched-new-delete`)
+     */
+    class allocator_ref final {
+        friend class promise_alloc;
+        using acquire_fn = void* (*)(size_t size, const void* alloc) noexcept(false);
+
+        const void* alloc;
+        acquire_fn acquire;
+
+      public:
+        template <typename Alloc>
+        allocator_ref(const Alloc& a) noexcept
+            : alloc{std::addressof(a)}, acquire{&promise_alloc::acquire<Alloc>} {
+        }
+    };
+    /// @brief The other arguments of the coroutine. They are not used
+    struct any_arg final {
+        template <typename T>
+        any_arg(const T&) noexcept {
+        }
+    };
+
+  public:
+    /**
+     * @brief Allocate the frame from the `frame_recycler` of the current thread
+     * @throw std::bad_alloc
+     */
+    static void* operator new(size_t size) noexcept(false) {
+        const auto total = fn_offset(size) + sizeof(deallocate_fn);
+        auto recycler = frame_recycler::current();
+        auto frame = recycler ? recycler->allocate(total) : ::operator new(total);
+        return bind(frame, size, &recycle);
+    }
+    /**
+     * @brief Allocate the frame with the allocator in the arguments.
+     *        The allocator is copied after the frame to deallocate it later
+     * @note  Up to 4 arguments after the allocator. The others fail to compile
+     * 
+     * ```cpp
+     * auto parse(std::allocator_arg_t, arena_allocator<byte> alloc, string_view text)
+     *     -> enumerable<token_t>;
+     * ```
+     */
+    static void* operator new(size_t size, std::allocator_arg_t,
+                              allocator_ref a) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, std::allocator_arg_t, allocator_ref a,
+                              any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, std::allocator_arg_t, allocator_ref a,
+                              any_arg, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, std::allocator_arg_t, allocator_ref a,
+                              any_arg, any_arg, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, std::allocator_arg_t, allocator_ref a,
+                              any_arg, any_arg, any_arg, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    /// @brief For the member function. The first argument is the object
+    static void* operator new(size_t size, any_arg, std::allocator_arg_t,
+                              allocator_ref a) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, any_arg, std::allocator_arg_t,
+                              allocator_ref a, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, any_arg, std::allocator_arg_t,
+                              allocator_ref a, any_arg, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, any_arg, std::allocator_arg_t, allocator_ref a,
+                              any_arg, any_arg, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    static void* operator new(size_t size, any_arg, std::allocator_arg_t, allocator_ref a,
+                              any_arg, any_arg, any_arg, any_arg) noexcept(false) {
+        return a.acquire(size, a.alloc);
+    }
+    /**
+     * @brief Without this, the frame silently falls back to `operator new(size_t)`
+     *        and the allocator in the arguments is ignored
+     * @note  Not `= delete`. GCC falls back to `operator new(size_t)` for the deleted one
+     */
+    template <typename... Args,
+              std::enable_if_t<unsupported_args<Args...>(), int> = 0>
+    static void* operator new(size_t, Args&&...) noexcept(false) {
+        static_assert(unsupported_args<Args...>() == false,
+                      "promise_alloc: the allocator must be the 1st argument(2nd "
+                      "for the member function) with up to 4 arguments after it");
+        throw std::bad_alloc{};
+    }
+
+    /// @note The frame is released with this in any case. see `deallocate_fn`
+    static void operator delete(void* frame, size_t size) noexcept {
+        auto fn = *reinterpret_cast<deallocate_fn*>(static_cast<std::byte*>(frame) +
+                                                    fn_offset(size));
+        return fn(frame, size);
+    }
+};
+
+/**
+ * @brief Yield all elements of the other `enumerable`.
+ *        The nested generator is resumed directly by the iterator
+ * 
+ * ```cpp
+ * auto walk(node_t& node) -> enumerable<node_t> {
+ *     co_yield node;
+ *     for (auto& child : node.children)
+ *         co_yield elements_of(walk(child));
+ * }
+ * ```
+ * 
+ * @tparam R `enumerable<T>&&`
+ * @see P2502 `std::generator`
+ */
+template <typename R>
+struct elements_of final {
+    R range;
+
+    explicit elements_of(R&& r) noexcept : range{std::forward<R>(r)} {
+    }
+};
+template <typename R>
+elements_of(R&&) -> elements_of<R&&>;
+
 /**
  * @brief C++ Coroutines Generator
+ * @note  With `elements_of`, the iterator resumes the innermost generator.
+ *        So the recursion costs 1 resume for each element regardless of the depth
  * 
  * @tparam T Type of the element
  * @see N4402
@@ -69,28 +365,88 @@ class enumerable {
     }
 
   public:
-    class promise_type final : public promise_aa {
+    class promise_type final : public promise_aa, public promise_alloc {
         friend class iterator;
         friend class enumerable;
 
-        pointer current = nullptr;
+        pointer current = nullptr;  // valid in the root
+        promise_type* root = this;  // the frame which is owned by the iterator
+        coroutine_handle<promise_type> leaf{};   // innermost generator. in the root
+        coroutine_handle<promise_type> parent{}; // the generator which yields this
+        std::exception_ptr exception{};          // for the parent
+
+        /// @brief Start the nested generator. It will switch back when it returns
+        class nested_awaiter final {
+            enumerable nested;
+
+          public:
+            explicit nested_awaiter(enumerable&& gen) noexcept
+                : nested{std::move(gen)} {
+            }
+
+            bool await_ready() noexcept {
+                return nested.coro == nullptr;
+            }
+            coroutine_handle<void>
+            await_suspend(coroutine_handle<promise_type> frame) noexcept {
+                auto& promise = nested.coro.promise();
+                promise.root = frame.promise().root;
+                promise.parent = frame;
+                promise.root->leaf = nested.coro;
+                return nested.coro;
+            }
+            /// @throw The exception from the nested generator
+            void await_resume() noexcept(false) {
+                if (nested.coro == nullptr)
+                    return;
+                if (auto& ex = nested.coro.promise().exception)
+                    std::rethrow_exception(std::exchange(ex, nullptr));
+            }
+        };
+
+        /// @brief Switch back to the parent if the generator is nested
+        struct final_awaiter final {
+            bool await_ready() noexcept {
+                return false;
+            }
+            coroutine_handle<void>
+            await_suspend(coroutine_handle<promise_type> frame) noexcept {
+                auto& promise = frame.promise();
+                if (promise.parent == nullptr)
+                    return noop_coroutine();
+                promise.root->leaf = promise.parent;
+                return promise.parent;
+            }
+            void await_resume() noexcept {
+            }
+        };
 
       public:
         /**
          * @brief create coroutine handle from current promise's address
          */
         enumerable get_return_object() noexcept {
-            return enumerable{
-                coroutine_handle<promise_type>::from_promise(*this)};
+            leaf = coroutine_handle<promise_type>::from_promise(*this);
+            return enumerable{leaf};
+        }
+        final_awaiter final_suspend() noexcept {
+            return {};
         }
+        /// @note The nested generator delivers the exception to its parent
         void unhandled_exception() noexcept(false) {
-            throw;
+            if (parent == nullptr)
+                throw;
+            exception = std::current_exception();
         }
         /// @brief  `co_yield` expression. for reference
         auto yield_value(reference ref) noexcept {
-            current = std::addressof(ref);
+            root->current = std::addressof(ref);
             return suspend_always{};
         }
+        /// @brief  `co_yield` expression. for the nested generator
+        nested_awaiter yield_value(elements_of<enumerable&&> e) noexcept {
+            return nested_awaiter{std::move(e.range)};
+        }
         /// @brief  `co_yield` expression. for r-value
         auto yield_value(value_type&& v) noexcept {
             return yield_value(v);
@@ -105,9 +461,14 @@ class enumerable {
         }
     };
 
+    /**
+     * @note `iterator_category` is for the legacy algorithms.
+     *       For C++20 ranges, it is an input iterator. The frame can't be restarted
+     */
     class iterator final {
       public:
         using iterator_category = std::forward_iterator_tag;
+        using iterator_concept = std::input_iterator_tag;
         using difference_type = ptrdiff_t;
         using value_type = T;
         using reference = value_type&;
@@ -117,6 +478,9 @@ class enumerable {
         coroutine_handle<promise_type> coro;
 
       public:
+        /// @see enumerable::end()
+        iterator() noexcept : coro{nullptr} {
+        }
         /// @see enumerable::end()
         explicit iterator(std::nullptr_t) noexcept : coro{nullptr} {
         }
@@ -126,20 +490,22 @@ class enumerable {
         }
 
       public:
-        /// @brief post increment is prohibited
-        iterator& operator++(int) = delete;
+        /// @brief post increment doesn't return the previous one
+        void operator++(int) noexcept(false) {
+            ++(*this);
+        }
         iterator& operator++() noexcept(false) {
-            coro.resume();
+            coro.promise().leaf.resume();
             if (coro.done())    // enumerable will destroy
                 coro = nullptr; // the frame later...
             return *this;
         }
 
-        pointer operator->() noexcept {
+        pointer operator->() const noexcept {
             pointer ptr = coro.promise().current;
             return ptr;
         }
-        reference operator*() noexcept {
+        reference operator*() const noexcept {
             return *(this->operator->());
         }
 
@@ -152,6 +518,560 @@ class enumerable {
     };
 };
 
+/**
+ * @brief Generator which can `co_await` between the `co_yield`s
+ * @details The consumer resumes the producer with `co_await next()`.
+ *          The producer may suspend for the I/O. Its next `co_yield`(or `co_return`)
+ *          resumes the consumer in the thread of the producer
+ * 
+ * ```cpp
+ * auto read_rows(uint64_t sd) -> async_enumerable<row_t> {
+ *     io_work_t work{};
+ *     array<byte, 4096> buf{};
+ *     while (auto sz = co_await recv_stream(sd, buf, 0, work); sz > 0)
+ *         for (auto& row : parse(buf, sz))
+ *             co_yield row;
+ * }
+ * auto consume(uint64_t sd) -> frame_t {
+ *     auto rows = read_rows(sd);
+ *     while (row_t* row = co_await rows.next())
+ *         // ...
+ * }
+ * ```
+ * 
+ * @tparam T Type of the element
+ */
+template <typename T>
+class async_enumerable {
+  public:
+    class promise_type;
+    class next_awaiter;
+
+    using value_type = T;
+    using reference = value_type&;
+    using pointer = value_type*;
+
+  private:
+    coroutine_handle<promise_type> coro{};
+
+  public:
+    async_enumerable(const async_enumerable&) = delete;
+    async_enumerable& operator=(const async_enumerable&) = delete;
+    async_enumerable(async_enumerable&& rhs) noexcept : coro{rhs.coro} {
+        rhs.coro = nullptr;
+    }
+    async_enumerable& operator=(async_enumerable&& rhs) noexcept {
+        std::swap(coro, rhs.coro);
+        return *this;
+    }
+    async_enumerable() noexcept = default;
+    explicit async_enumerable(coroutine_handle<promise_type> rh) noexcept
+        : coro{rh} {
+    }
+    /**
+     * @brief The frame must not be running(suspended in the I/O) at this moment
+     */
+    ~async_enumerable() noexcept {
+        if (coro)
+            coro.destroy();
+    }
+
+  public:
+    /**
+     * @brief Resume the producer until its next `co_yield`
+     * @return next_awaiter The result is the pointer to the value. `nullptr` after the `co_return`
+     */
+    next_awaiter next() noexcept {
+        return next_awaiter{coro};
+    }
+
+  public:
+    class promise_type final : public promise_alloc {
+        friend class next_awaiter;
+
+        pointer current = nullptr;
+        coroutine_handle<void> consumer{};
+        std::exception_ptr exception{};
+
+        /// @brief Switch to the consumer which is waiting in the `next`
+        struct yield_awaiter final {
+            coroutine_handle<void> consumer;
+
+            bool await_ready() noexcept {
+                return false;
+            }
+            coroutine_handle<void> await_suspend(coroutine_handle<void>) noexcept {
+                return consumer;
+            }
+            void await_resume() noexcept {
+            }
+        };
+
+      public:
+        async_enumerable get_return_object() noexcept {
+            return async_enumerable{
+                coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        /// @brief Lazy. The first `next` starts the producer
+        suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        /// @brief The consumer is resumed for the `nullptr`
+        yield_awaiter final_suspend() noexcept {
+            return {consumer};
+        }
+        /// @brief `next` will rethrow it in the consumer
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+        /// @brief  `co_yield` expression. for reference
+        yield_awaiter yield_value(reference ref) noexcept {
+            current = std::addressof(ref);
+            return {consumer};
+        }
+        /// @brief  `co_yield` expression. for r-value
+        yield_awaiter yield_value(value_type&& v) noexcept {
+            return yield_value(v);
+        }
+        void return_void() noexcept {
+            current = nullptr;
+        }
+    };
+
+    class next_awaiter final {
+        coroutine_handle<promise_type> coro;
+
+      public:
+        explicit next_awaiter(coroutine_handle<promise_type> handle) noexcept
+            : coro{handle} {
+        }
+
+        /// @brief There is nothing to resume
+        bool await_ready() noexcept {
+            return coro == nullptr || coro.done();
+        }
+        /// @brief Switch to the producer. It will switch back with the value
+        coroutine_handle<void> await_suspend(coroutine_handle<void> consumer) noexcept {
+            coro.promise().consumer = consumer;
+            return coro;
+        }
+        /// @throw The exception from the producer
+        pointer await_resume() noexcept(false) {
+            if (coro == nullptr)
+                return nullptr;
+            auto& promise = coro.promise();
+            if (promise.exception)
+                std::rethrow_exception(std::exchange(promise.exception, nullptr));
+            return coro.done() ? nullptr : promise.current;
+        }
+    };
+};
+
+/**
+ * @defgroup Pipeline
+ * @brief Lazy adaptors for `enumerable` and the other input ranges.
+ *        Each stage is an iterator over the previous one.
+ *        So the pipeline resumes the generator once for each element
+ *        without allocating the frame for the stage
+ * 
+ * ```cpp
+ * for (auto& rows : read_lines(file)
+ *                       | filter([](string_view line) { return line.size(); })
+ *                       | transform(parse_row)
+ *                       | take(1000)
+ *                       | chunk(64))
+ *     insert(rows);
+ * ```
+ */
+
+/**
+ * @brief End of the adaptor's iterator
+ * @ingroup Pipeline
+ */
+struct pipeline_sentinel final {};
+
+namespace internal {
+
+template <typename Range>
+using iterator_of_t = decltype(std::declval<Range&>().begin());
+template <typename Range>
+using sentinel_of_t = decltype(std::declval<Range&>().end());
+template <typename Range>
+using reference_of_t = decltype(*std::declval<iterator_of_t<Range>&>());
+
+/**
+ * @brief Position in the source range. Only the adaptors use this
+ * @note  `take`/`chunk` must not advance the source after the last element.
+ *        It will resume the generator for nothing
+ */
+template <typename Range>
+struct pipeline_cursor {
+    iterator_of_t<Range> it;
+    sentinel_of_t<Range> last;
+
+    bool done() const noexcept(false) {
+        return !(it != last);
+    }
+};
+
+/// @brief Pipe the range into the adaptor. The rvalue range is moved in
+template <template <typename, typename> class View, typename Arg>
+struct pipeline_closure final {
+    Arg arg;
+
+    template <typename Range>
+    friend auto operator|(Range&& range, pipeline_closure c) {
+        return View<Range, Arg>{std::forward<Range>(range), std::move(c.arg)};
+    }
+};
+
+} // namespace internal
+
+/**
+ * @brief Apply the function to each element
+ * @ingroup Pipeline
+ */
+template <typename Range, typename Fn>
+class transform_view final {
+    Range range; // `R&` for the lvalue
+    Fn fn;
+
+  public:
+    class iterator final {
+        internal::pipeline_cursor<Range> cursor;
+        Fn* fn;
+
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using reference = std::invoke_result_t<Fn&, internal::reference_of_t<Range>>;
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+
+      public:
+        iterator(internal::pipeline_cursor<Range>&& c, Fn* f) noexcept
+            : cursor{std::move(c)}, fn{f} {
+        }
+
+        reference operator*() const noexcept(false) {
+            return (*fn)(*cursor.it);
+        }
+        iterator& operator++() noexcept(false) {
+            ++cursor.it;
+            return *this;
+        }
+        void operator++(int) noexcept(false) {
+            ++(*this);
+        }
+        bool operator==(pipeline_sentinel) const noexcept(false) {
+            return cursor.done();
+        }
+        bool operator!=(pipeline_sentinel) const noexcept(false) {
+            return !cursor.done();
+        }
+    };
+
+  public:
+    transform_view(Range&& r, Fn&& f) noexcept(false)
+        : range{std::forward<Range>(r)}, fn{std::move(f)} {
+    }
+
+    iterator begin() noexcept(false) {
+        return iterator{{range.begin(), range.end()}, std::addressof(fn)};
+    }
+    pipeline_sentinel end() noexcept {
+        return {};
+    }
+};
+
+/**
+ * @brief Skip the elements which doesn't satisfy the predicate
+ * @ingroup Pipeline
+ */
+template <typename Range, typename Fn>
+class filter_view final {
+    Range range;
+    Fn pred;
+
+  public:
+    class iterator final {
+        internal::pipeline_cursor<Range> cursor;
+        Fn* pred;
+
+        void satisfy() noexcept(false) {
+            while (!cursor.done() && !(*pred)(*cursor.it))
+                ++cursor.it;
+        }
+
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using reference = internal::reference_of_t<Range>;
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+
+      public:
+        iterator(internal::pipeline_cursor<Range>&& c, Fn* f) noexcept(false)
+            : cursor{std::move(c)}, pred{f} {
+            satisfy();
+        }
+
+        reference operator*() const noexcept(false) {
+            return *cursor.it;
+        }
+        iterator& operator++() noexcept(false) {
+            ++cursor.it;
+            satisfy();
+            return *this;
+        }
+        void operator++(int) noexcept(false) {
+            ++(*this);
+        }
+        bool operator==(pipeline_sentinel) const noexcept(false) {
+            return cursor.done();
+        }
+        bool operator!=(pipeline_sentinel) const noexcept(false) {
+            return !cursor.done();
+        }
+    };
+
+  public:
+    filter_view(Range&& r, Fn&& f) noexcept(false)
+        : range{std::forward<Range>(r)}, pred{std::move(f)} {
+    }
+
+    iterator begin() noexcept(false) {
+        return iterator{{range.begin(), range.end()}, std::addressof(pred)};
+    }
+    pipeline_sentinel end() noexcept {
+        return {};
+    }
+};
+
+/**
+ * @brief Stop after the `count` elements.
+ *        The generator is not resumed after the last one
+ * @ingroup Pipeline
+ */
+template <typename Range, typename Size>
+class take_view final {
+    Range range;
+    Size count;
+
+  public:
+    class iterator final {
+        internal::pipeline_cursor<Range> cursor;
+        Size remain;
+
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using reference = internal::reference_of_t<Range>;
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+
+      public:
+        iterator(internal::pipeline_cursor<Range>&& c, Size n) noexcept
+            : cursor{std::move(c)}, remain{n} {
+        }
+
+        reference operator*() const noexcept(false) {
+            return *cursor.it;
+        }
+        iterator& operator++() noexcept(false) {
+            if (--remain > 0)
+                ++cursor.it;
+            return *this;
+        }
+        void operator++(int) noexcept(false) {
+            ++(*this);
+        }
+        bool operator==(pipeline_sentinel) const noexcept(false) {
+            return remain == 0 || cursor.done();
+        }
+        bool operator!=(pipeline_sentinel s) const noexcept(false) {
+            return !(*this == s);
+        }
+    };
+
+  public:
+    take_view(Range&& r, Size&& n) noexcept(false)
+        : range{std::forward<Range>(r)}, count{n} {
+    }
+
+    iterator begin() noexcept(false) {
+        return iterator{{range.begin(), range.end()}, count};
+    }
+    pipeline_sentinel end() noexcept {
+        return {};
+    }
+};
+
+/**
+ * @brief Group the elements with the `count`. The last one can be shorter.
+ *        The buffer is reused for each chunk
+ * @note  The elements are copied(or moved if it is a prvalue) into the buffer
+ * @ingroup Pipeline
+ */
+template <typename Range, typename Size>
+class chunk_view final {
+  public:
+    using element_type = std::remove_cv_t<
+        std::remove_reference_t<internal::reference_of_t<Range>>>;
+
+  private:
+    Range range;
+    Size count;
+    std::vector<element_type> buffer{};
+
+  public:
+    class iterator final {
+        internal::pipeline_cursor<Range> cursor;
+        Size count;
+        std::vector<element_type>* buffer;
+
+        void fill() noexcept(false) {
+            buffer->clear();
+            while (!cursor.done()) {
+                buffer->emplace_back(*cursor.it);
+                if (buffer->size() == count)
+                    return; // don't resume for the next chunk
+                ++cursor.it;
+            }
+        }
+
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using value_type = std::vector<element_type>;
+        using reference = const value_type&;
+
+      public:
+        iterator(internal::pipeline_cursor<Range>&& c, Size n,
+                 std::vector<element_type>* b) noexcept(false)
+            : cursor{std::move(c)}, count{n}, buffer{b} {
+            fill();
+        }
+
+        reference operator*() const noexcept {
+            return *buffer;
+        }
+        iterator& operator++() noexcept(false) {
+            if (buffer->size() == count && !cursor.done())
+                ++cursor.it;
+            fill();
+            return *this;
+        }
+        void operator++(int) noexcept(false) {
+            ++(*this);
+        }
+        bool operator==(pipeline_sentinel) const noexcept {
+            return buffer->empty();
+        }
+        bool operator!=(pipeline_sentinel) const noexcept {
+            return !buffer->empty();
+        }
+    };
+
+  public:
+    chunk_view(Range&& r, Size&& n) noexcept(false)
+        : range{std::forward<Range>(r)}, count{n} {
+        buffer.reserve(count);
+    }
+
+    iterator begin() noexcept(false) {
+        return iterator{{range.begin(), range.end()}, count, &buffer};
+    }
+    pipeline_sentinel end() noexcept {
+        return {};
+    }
+};
+
+/**
+ * @brief Pair the elements of the 2 ranges. Stops at the shorter one
+ * @ingroup Pipeline
+ */
+template <typename Range1, typename Range2>
+class zip_view final {
+    Range1 range1;
+    Range2 range2;
+
+  public:
+    class iterator final {
+        internal::pipeline_cursor<Range1> cursor1;
+        internal::pipeline_cursor<Range2> cursor2;
+
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using reference = std::pair<internal::reference_of_t<Range1>,
+                                    internal::reference_of_t<Range2>>;
+        using value_type = reference;
+
+      public:
+        iterator(internal::pipeline_cursor<Range1>&& c1,
+                 internal::pipeline_cursor<Range2>&& c2) noexcept
+            : cursor1{std::move(c1)}, cursor2{std::move(c2)} {
+        }
+
+        reference operator*() const noexcept(false) {
+            return reference{*cursor1.it, *cursor2.it};
+        }
+        iterator& operator++() noexcept(false) {
+            ++cursor1.it;
+            ++cursor2.it;
+            return *this;
+        }
+        void operator++(int) noexcept(false) {
+            ++(*this);
+        }
+        bool operator==(pipeline_sentinel) const noexcept(false) {
+            return cursor1.done() || cursor2.done();
+        }
+        bool operator!=(pipeline_sentinel s) const noexcept(false) {
+            return !(*this == s);
+        }
+    };
+
+  public:
+    zip_view(Range1&& r1, Range2&& r2) noexcept(false)
+        : range1{std::forward<Range1>(r1)}, range2{std::forward<Range2>(r2)} {
+    }
+
+    iterator begin() noexcept(false) {
+        return iterator{{range1.begin(), range1.end()},
+                        {range2.begin(), range2.end()}};
+    }
+    pipeline_sentinel end() noexcept {
+        return {};
+    }
+};
+
+/// @ingroup Pipeline
+template <typename Fn>
+auto transform(Fn&& fn) noexcept(false) {
+    using fn_t = std::decay_t<Fn>;
+    return internal::pipeline_closure<transform_view, fn_t>{std::forward<Fn>(fn)};
+}
+/// @ingroup Pipeline
+template <typename Fn>
+auto filter(Fn&& pred) noexcept(false) {
+    using fn_t = std::decay_t<Fn>;
+    return internal::pipeline_closure<filter_view, fn_t>{std::forward<Fn>(pred)};
+}
+/// @ingroup Pipeline
+inline auto take(size_t count) noexcept {
+    return internal::pipeline_closure<take_view, size_t>{count};
+}
+/// @ingroup Pipeline
+/// @param count must be larger than 0
+inline auto chunk(size_t count) noexcept {
+    return internal::pipeline_closure<chunk_view, size_t>{count};
+}
+/// @ingroup Pipeline
+template <typename Range1, typename Range2>
+auto zip(Range1&& r1, Range2&& r2) noexcept(false) {
+    return zip_view<Range1, Range2>{std::forward<Range1>(r1),
+                                    std::forward<Range2>(r2)};
+}
+
 } // namespace coro
 
 #endif // COROUTINE_YIELD_HPP
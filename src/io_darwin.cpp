@@ -1,7 +1,10 @@
 /**
  * @author github.com/luncliff (luncliff@gmail.com)
  */
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <vector>
 
 #include <coroutine/net.h>
 #include <coroutine/unix.h>
@@ -16,24 +19,33 @@ kqueue_owner netkq{};
 
 using net_callback_t = void (*)(void* ctx, coroutine_handle<void> coro);
 
-void poll_net_tasks(const timespec& wait_time, //
-                    net_callback_t callback, void* ctx) noexcept(false) {
+std::atomic<uint32_t> netcap{256};
 
-    constexpr auto buf_size = 30u;
-    auto buf = make_unique<kevent64_s[]>(buf_size);
+ptrdiff_t poll_net_tasks(const timespec& wait_time, //
+                         net_callback_t callback, void* ctx) noexcept(false) {
+    /// @brief Persistent event buffer for `netkq` in each thread. see `set_net_poll_capacity`
+    static thread_local std::vector<kevent64_s> netbuf{};
+    // the callback can change the capacity. apply it before the wait
+    if (const auto cap = netcap.load(memory_order_relaxed); netbuf.size() != cap)
+        netbuf.resize(cap);
 
-    const auto count = netkq.events(wait_time, {buf.get(), buf_size});
+    const auto count = netkq.events(wait_time, netbuf);
     for (auto i = 0; i < count; ++i) {
-        auto* work = reinterpret_cast<io_work_t*>(buf[i].udata);
+        auto* work = reinterpret_cast<io_work_t*>(netbuf[i].udata);
         callback(ctx, work->task);
     }
+    return count;
 }
 
 void resume_net_task(void*, coroutine_handle<void> coro) noexcept(false) {
     return coro.resume();
 }
 
-void poll_net_tasks(uint64_t nano) noexcept(false) {
+void set_net_poll_capacity(uint32_t count) noexcept(false) {
+    netcap.store(std::max(count, 1u), memory_order_relaxed);
+}
+
+ptrdiff_t poll_net_tasks(uint64_t nano) noexcept(false) {
     auto timeout = nanoseconds{nano};
     const auto sec = duration_cast<seconds>(timeout);
     const timespec wait_time{
@@ -43,7 +55,7 @@ void poll_net_tasks(uint64_t nano) noexcept(false) {
     return poll_net_tasks(wait_time, resume_net_task, nullptr);
 }
 
-bool io_work_t::ready() const noexcept {
+bool io_work_t::ready() noexcept {
     const auto sd = this->handle;
     // non blocking operation is expected
     // going to suspend
@@ -77,7 +89,7 @@ auto send_to(uint64_t sd, const sockaddr_in6& remote, io_buffer_t buffer,
     return *reinterpret_cast<io_send_to*>(addressof(work));
 }
 
-void io_send_to::suspend(coroutine_handle<void> rh) noexcept(false) {
+bool io_send_to::suspend(coroutine_handle<void> rh) noexcept(false) {
     static_assert(sizeof(void*) <= sizeof(uint64_t));
     task = rh;
 
@@ -91,6 +103,7 @@ void io_send_to::suspend(coroutine_handle<void> rh) noexcept(false) {
     req.udata = reinterpret_cast<uint64_t>(static_cast<io_work_t*>(this));
 
     netkq.change(req);
+    return true;
 }
 
 int64_t io_send_to::resume() noexcept {
@@ -121,7 +134,7 @@ auto recv_from(uint64_t sd, sockaddr_in6& remote, io_buffer_t buffer,
     return *reinterpret_cast<io_recv_from*>(addressof(work));
 }
 
-void io_recv_from::suspend(coroutine_handle<void> rh) noexcept(false) {
+bool io_recv_from::suspend(coroutine_handle<void> rh) noexcept(false) {
     static_assert(sizeof(void*) <= sizeof(uint64_t));
 
     task = rh;
@@ -139,6 +152,7 @@ void io_recv_from::suspend(coroutine_handle<void> rh) noexcept(false) {
     req.udata = reinterpret_cast<uint64_t>(static_cast<io_work_t*>(this));
 
     netkq.change(req);
+    return true;
 }
 
 int64_t io_recv_from::resume() noexcept {
@@ -161,7 +175,7 @@ auto send_stream(uint64_t sd, io_buffer_t buffer, uint32_t flag,
     return *reinterpret_cast<io_send*>(addressof(work));
 }
 
-void io_send::suspend(coroutine_handle<void> rh) noexcept(false) {
+bool io_send::suspend(coroutine_handle<void> rh) noexcept(false) {
     static_assert(sizeof(void*) <= sizeof(uint64_t));
     task = rh;
 
@@ -175,6 +189,7 @@ void io_send::suspend(coroutine_handle<void> rh) noexcept(false) {
     req.udata = reinterpret_cast<uint64_t>(static_cast<io_work_t*>(this));
 
     netkq.change(req);
+    return true;
 }
 
 int64_t io_send::resume() noexcept {
@@ -195,7 +210,7 @@ auto recv_stream(uint64_t sd, io_buffer_t buffer, uint32_t flag,
     return *reinterpret_cast<io_recv*>(addressof(work));
 }
 
-void io_recv::suspend(coroutine_handle<void> rh) noexcept(false) {
+bool io_recv::suspend(coroutine_handle<void> rh) noexcept(false) {
     static_assert(sizeof(void*) <= sizeof(uint64_t));
 
     task = rh;
@@ -209,6 +224,7 @@ void io_recv::suspend(coroutine_handle<void> rh) noexcept(false) {
     req.udata = reinterpret_cast<uint64_t>(static_cast<io_work_t*>(this));
 
     netkq.change(req);
+    return true;
 }
 
 int64_t io_recv::resume() noexcept {
@@ -1,7 +1,18 @@
 /**
  * @author github.com/luncliff (luncliff@gmail.com)
  */
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <deque>
+#include <exception>
+#include <linux/errqueue.h>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/timerfd.h>
 
 #include <coroutine/linux.h>
 #include <coroutine/net.h>
@@ -12,37 +23,854 @@ using namespace std::chrono;
 
 namespace coro {
 
-epoll_owner iep{}, oep{}; // inbound, outbound
+/**
+ * @brief `epoll_event::data.u64` of `io_registration` is `(sd << 1) | registration_tag`
+ * @note  The coroutine frames and the markers are aligned. Their lowest bit is 0
+ */
+constexpr uint64_t registration_tag = 1;
 
-void poll_net_tasks(uint64_t nano) noexcept(false) {
-    const auto half_time = duration_cast<milliseconds>(nanoseconds{nano} / 2);
-    // event buffer for this poll
-    constexpr auto buf_sz = 30u;
-    auto buf = make_unique<epoll_event[]>(buf_sz);
-    // resume inbound coroutines
-    {
-        auto count = iep.wait(half_time.count(), {buf.get(), buf_sz});
-        for (auto i = 0u; i < count; ++i)
-            if (auto coro =
-                    coroutine_handle<void>::from_address(buf[i].data.ptr))
-                coro.resume();
+/**
+ * @brief Epoll(and io_uring) for 1 polling thread
+ * @note  The outbound epoll and the io_uring are nested in the inbound epoll.
+ *        So 1 `epoll_wait` can detect all of them.
+ *        The `epoll_event` for them holds their address as a marker
+ */
+struct io_poller_t final {
+    static constexpr uint32_t default_capacity = 256;
+
+    epoll_owner inbound{}, outbound{};
+#if defined(COROUTINE_USE_IO_URING)
+    io_uring_owner ring{};
+#endif
+    /// @brief Only 1 thread polls at once. The others wait for it. see `expire`
+    std::mutex pmtx{};
+    /// @brief The front half is for the inbound. The back half is for the outbound
+    std::vector<epoll_event> events;
+    std::atomic<uint32_t> capacity; /// Applied to `events` in the next `poll`
+    /// @brief `timerfd` for the earliest deadline. `deadlines` is its marker
+    int64_t tfd;
+    std::mutex tmtx{};
+    std::set<std::pair<int64_t, io_deadline_t*>> deadlines{};
+
+  public:
+    explicit io_poller_t(uint32_t _capacity = default_capacity) noexcept(false)
+        : events(2 * std::max(_capacity, 1u)), capacity{std::max(_capacity, 1u)},
+          tfd{timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)} {
+        if (tfd < 0)
+            throw system_error{errno, system_category(), "timerfd_create"};
+        nest(tfd, addressof(deadlines));
+        nest(outbound.fd(), addressof(outbound));
+#if defined(COROUTINE_USE_IO_URING)
+        nest(ring.fd(), addressof(ring));
+#endif
+    }
+    ~io_poller_t() noexcept {
+        close(tfd);
+    }
+
+    /**
+     * @brief Bind the fd to the inbound epoll
+     * @param marker `epoll_event::data.ptr` which is not a coroutine
+     */
+    void nest(int64_t fd, void* marker) noexcept(false) {
+        epoll_event req{};
+        req.events = EPOLLIN; // level-triggered. drained in `poll`
+        req.data.ptr = marker;
+        inbound.try_add(fd, req);
+    }
+
+    /**
+     * @brief Change the number of events for each direction in 1 `poll`
+     * @note  The resumed coroutines can invoke this. The buffer is reallocated in the next `poll`
+     */
+    void reserve(uint32_t count) noexcept {
+        capacity.store(std::max(count, 1u), memory_order_relaxed);
+    }
+
+    /**
+     * @brief Wait for the inbound epoll and resume the coroutines in the events
+     * @note  The callers are serialized. The resumed coroutines must not `poll` again
+     * @param marker `epoll_event::data.ptr` from the other `nest`
+     * @param notify invoked with the marker event
+     * @return ptrdiff_t the number of the resumed coroutines
+     */
+    template <typename Fn>
+    ptrdiff_t poll(uint32_t wait_ms, void* marker, Fn&& notify) noexcept(false) {
+        // the events of 1 `epoll_wait` must be dispatched before the other `expire`
+        unique_lock lck{pmtx};
+#if defined(COROUTINE_USE_IO_URING)
+        // flush the batched submissions before the wait
+        ring.submit();
+#endif
+        const auto half = capacity.load(memory_order_relaxed);
+        if (events.size() != 2 * half)
+            events.resize(2 * half);
+        gsl::span<epoll_event> buf{events};
+        const auto count = inbound.wait(wait_ms, buf.first(half));
+        ptrdiff_t total = 0;
+        bool expiring = false;
+        for (auto i = 0; i < count; ++i) {
+            void* ptr = buf[i].data.ptr;
+            if (ptr == marker) {
+                notify();
+                continue;
+            }
+            if (ptr == addressof(deadlines)) {
+                // the resumed ones in this batch will disarm their deadlines
+                expiring = true;
+                continue;
+            }
+            if (buf[i].data.u64 & registration_tag) {
+                total += dispatch(buf[i]);
+                continue;
+            }
+            if (ptr == addressof(outbound)) {
+                total += poll_outbound(buf.subspan(half));
+                continue;
+            }
+#if defined(COROUTINE_USE_IO_URING)
+            if (ptr == addressof(ring)) {
+                total += poll_ring(half);
+                continue;
+            }
+#endif
+            if (auto coro = coroutine_handle<void>::from_address(ptr))
+                total += io_deadline_t::resume(coro);
+        }
+        if (expiring)
+            total += expire();
+        return total;
+    }
+
+    /// @brief Add the deadline. The timer is updated for the earliest one
+    void schedule(io_deadline_t& d) noexcept(false);
+    /// @brief Remove the deadline. Wait for the `expire` which is using it
+    void unschedule(io_deadline_t& d) noexcept;
+
+  private:
+    /// @brief Cancel the operations of the expired deadlines
+    ptrdiff_t expire() noexcept(false);
+    /**
+     * @brief Cancel the suspended operation of the deadline and `claim` it
+     * @return true The operation is cancelled. The coroutine must be resumed
+     */
+    bool cancel(io_deadline_t& d) noexcept;
+
+    /// @brief The event is from `io_registration`. see `registration_tag`
+    ptrdiff_t dispatch(const epoll_event& e) noexcept(false) {
+        const auto sd = static_cast<int64_t>(e.data.u64 >> 1);
+        // the registration might be destroyed by the previous event
+        if (auto reg = io_registration::find(sd))
+            return reg->notify(e.events);
+        return 0;
+    }
+    /// @brief outbound is ready. it won't block
+    ptrdiff_t poll_outbound(gsl::span<epoll_event> events) noexcept(false) {
+        const auto count = outbound.wait(0, events);
+        ptrdiff_t total = 0;
+        for (auto i = 0; i < count; ++i)
+            if (auto coro = coroutine_handle<void>::from_address(events[i].data.ptr))
+                total += io_deadline_t::resume(coro);
+        return total;
+    }
+#if defined(COROUTINE_USE_IO_URING)
+    /**
+     * @brief CQ has entries. it won't block
+     * @param limit The remaining CQEs are for the next `poll`. The ring's fd is level-triggered
+     */
+    ptrdiff_t poll_ring(size_t limit) noexcept(false) {
+        std::array<io_uring_cqe, 32> cqes{};
+        size_t reaped = 0;
+        ptrdiff_t total = 0;
+        while (reaped < limit) {
+            const auto n = std::min(cqes.size(), limit - reaped);
+            const auto count = ring.reap(gsl::span{cqes}.first(n));
+            for (auto i = 0; i < count; ++i)
+                total += complete(cqes[i]);
+            reaped += count;
+            if (static_cast<size_t>(count) < n) // drained
+                break;
+        }
+        return total;
+    }
+    /// @return true The coroutine of the CQE is resumed
+    bool complete(const io_uring_cqe& cqe) noexcept(false);
+
+  public:
+    /**
+     * @brief Fill the SQE for the work in the ring
+     * @note  If the work waits for `with_timeout`, `IORING_OP_LINK_TIMEOUT` follows it.
+     *        The kernel cancels only the linked one. A reused `io_work_t` is not affected
+     */
+    template <typename Fn>
+    void prepare(io_work_t& work, Fn&& fill) noexcept(false) {
+        auto d = io_deadline_t::from(work.task);
+        if (d == nullptr)
+            return ring.prepare(fill);
+        ring.prepare(fill, [d](io_uring_sqe& sqe) {
+            sqe.opcode = IORING_OP_LINK_TIMEOUT;
+            sqe.fd = -1;
+            sqe.addr = reinterpret_cast<uint64_t>(d->spec);
+            sqe.len = 1;
+            sqe.timeout_flags = IORING_TIMEOUT_ABS;
+            sqe.user_data = 0;
+        });
+    }
+#endif
+};
+
+io_poller_t& global_poller() noexcept(false) {
+    static io_poller_t poller{};
+    return poller;
+}
+
+ptrdiff_t poll_net_tasks(uint64_t nano) noexcept(false) {
+    const auto timeout = duration_cast<milliseconds>(nanoseconds{nano});
+    return global_poller().poll(timeout.count(), nullptr, []() {});
+}
+
+void set_net_poll_capacity(uint32_t count) noexcept(false) {
+    return global_poller().reserve(count);
+}
+
+/// @brief `io_control_block::internal` is `uint32_t errc, int32_t flag`
+uint32_t flag_of(const io_work_t& work) noexcept {
+    return static_cast<uint32_t>(work.internal >> 32);
+}
+void set_error(io_work_t& work, uint32_t errc) noexcept {
+    work.internal = (work.internal & 0xFFFF'FFFF'0000'0000) | errc;
+}
+
+/**
+ * @brief `io_control_block::handle` is `int32_t sd, uint32_t state`
+ * @note  The blocking mode of the socket is kept for the next operations with the same work
+ */
+enum io_state_t : uint64_t {
+    mode_blocking = 1ull << 32,
+    mode_nonblocking = 2ull << 32,
+    mode_mask = mode_blocking | mode_nonblocking, // 0 if not known
+    op_send_to = 0ull << 34,
+    op_recv_from = 1ull << 34,
+    op_send = 2ull << 34,
+    op_recv = 3ull << 34,
+    op_send_msg = 4ull << 34,
+    op_recv_msg = 5ull << 34,
+    op_send_mmsg = 6ull << 34,
+    op_recv_mmsg = 7ull << 34,
+    op_accept = 8ull << 34,
+    op_accept_many = 9ull << 34,
+    op_connect = 10ull << 34,
+    op_send_file = 11ull << 34,
+    op_recv_zerocopy = 12ull << 34,
+    op_mask = 15ull << 34,
+    result_ready = 1ull << 38, // the operation is done before `resume`
+};
+
+int32_t socket_of(const io_work_t& work) noexcept {
+    return static_cast<int32_t>(work.handle & 0xFFFF'FFFF);
+}
+
+/// @brief `fcntl` for the blocking mode of the socket
+uint64_t query_mode(int64_t sd) noexcept {
+    const auto flags = fcntl(static_cast<int>(sd), F_GETFL, 0);
+    // if failed, the operation will report the error
+    return (flags != -1 && (flags & O_NONBLOCK) == 0) ? mode_blocking
+                                                      : mode_nonblocking;
+}
+
+/**
+ * @brief Prepare the work for the operation. The blocking mode is kept for the same socket
+ * @note  `fcntl` only for the first operation of the work.
+ *        The awaitable can be copied by the compiler. The state must be updated here.
+ *        The cached mode can be stale if the socket is changed to non-blocking.
+ *        `io_registration` does it, and `io_work_t::ready` handles the others with `EAGAIN`
+ */
+void bind_socket(io_work_t& work, uint64_t sd, io_state_t op) noexcept {
+    auto mode = static_cast<uint64_t>(work.handle) & mode_mask;
+    if (static_cast<uint64_t>(socket_of(work)) != sd || mode == 0)
+        mode = query_mode(static_cast<int64_t>(sd));
+    else if (mode == mode_blocking && io_registration::find(static_cast<int64_t>(sd)))
+        mode = mode_nonblocking; // the registration made it non-blocking
+    work.handle = static_cast<int64_t>(sd | mode | op);
+}
+
+bool has_result(const io_work_t& work) noexcept {
+    return work.handle & result_ready;
+}
+void set_result(io_work_t& work, int64_t sz) noexcept {
+    work.internal_high = static_cast<uint64_t>(sz);
+    work.handle |= result_ready;
+}
+
+/**
+ * @brief Thread-owned resources of the `io_context`
+ * @note  The `eventfd` wakes up the worker for `post` and `stop`
+ */
+struct io_context::worker_t final {
+    io_poller_t poller;
+    int64_t efd;
+    std::mutex mtx{};
+    std::deque<coroutine_handle<void>> tasks{};
+
+  public:
+    explicit worker_t(uint32_t capacity) noexcept(false)
+        : poller{capacity}, efd{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)} {
+        if (efd < 0)
+            throw system_error{errno, system_category(), "eventfd"};
+        poller.nest(efd, this); // consumed in `drain`
+    }
+    ~worker_t() noexcept {
+        close(efd);
+    }
+
+    void notify() noexcept(false) {
+        if (eventfd_write(efd, 1) != 0)
+            throw system_error{errno, system_category(), "eventfd_write"};
+    }
+    void push(coroutine_handle<void> coro) noexcept(false) {
+        {
+            unique_lock lck{mtx};
+            tasks.push_back(coro);
+        }
+        notify();
+    }
+    /// @brief Resume all posted coroutines
+    void drain() noexcept(false) {
+        eventfd_t count{};
+        eventfd_read(efd, &count); // EAGAIN is ok. already consumed
+        std::deque<coroutine_handle<void>> ready{};
+        {
+            unique_lock lck{mtx};
+            ready.swap(tasks);
+        }
+        for (auto coro : ready)
+            coro.resume();
+    }
+};
+
+/// @brief The worker of the current thread. `nullptr` if the thread is not a worker
+thread_local io_context::worker_t* current_worker = nullptr;
+
+io_poller_t& current_poller() noexcept(false) {
+    return current_worker ? current_worker->poller : global_poller();
+}
+
+/**
+ * @brief `sd` to `io_registration` for the awaitables
+ * @note  The lookup is lock-free. The chunks are released at the program's exit
+ */
+class io_registry_t final {
+    static constexpr size_t chunk_size = 1024;
+    static constexpr size_t chunk_count = 1024; // up to 1M descriptors
+    using chunk_t = std::array<std::atomic<io_registration*>, chunk_size>;
+
+    std::array<std::atomic<chunk_t*>, chunk_count> chunks{};
+
+  public:
+    ~io_registry_t() noexcept {
+        for (auto& chunk : chunks)
+            delete chunk.load(memory_order_acquire);
+    }
+
+    /// @return `nullptr` if the chunk for the `sd` is not allocated
+    std::atomic<io_registration*>* find(int64_t sd) noexcept {
+        if (sd < 0 || static_cast<size_t>(sd) >= chunk_size * chunk_count)
+            return nullptr;
+        auto chunk = chunks[sd / chunk_size].load(memory_order_acquire);
+        return chunk ? addressof((*chunk)[sd % chunk_size]) : nullptr;
+    }
+
+    /// @throw system_error the `sd` is out of range
+    std::atomic<io_registration*>& at(int64_t sd) noexcept(false) {
+        if (sd < 0 || static_cast<size_t>(sd) >= chunk_size * chunk_count)
+            throw system_error{EBADF, system_category(), "io_registration"};
+        auto& slot = chunks[sd / chunk_size];
+        auto chunk = slot.load(memory_order_acquire);
+        if (chunk == nullptr) {
+            auto created = new chunk_t{};
+            if (slot.compare_exchange_strong(chunk, created, memory_order_acq_rel))
+                chunk = created;
+            else // the other thread allocated it
+                delete created;
+        }
+        return (*chunk)[sd % chunk_size];
+    }
+};
+
+io_registry_t& io_registry() noexcept {
+    static io_registry_t registry{};
+    return registry;
+}
+
+/// @brief The slot of `io_registration` has the readiness without parked coroutine
+void* const ready_marker = reinterpret_cast<void*>(registration_tag);
+
+io_registration::io_registration(int64_t _sd) noexcept(false)
+    : sd{_sd}, ep{nullptr}, inbound{nullptr}, outbound{nullptr} {
+    auto& entry = io_registry().at(sd);
+    if (const auto flags = fcntl(sd, F_GETFL, 0); (flags & O_NONBLOCK) == 0)
+        if (fcntl(sd, F_SETFL, flags | O_NONBLOCK) != 0)
+            throw system_error{errno, system_category(), "fcntl"};
+    // the first edge can be reported right after the EPOLL_CTL_ADD
+    entry.store(this, memory_order_release);
+#if !defined(COROUTINE_USE_IO_URING)
+    auto& poller = current_poller();
+    epoll_event req{};
+    req.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    req.data.u64 = (static_cast<uint64_t>(sd) << 1) | registration_tag;
+    try {
+        poller.inbound.try_add(sd, req);
+    } catch (...) {
+        entry.store(nullptr, memory_order_release);
+        throw;
+    }
+    ep = addressof(poller.inbound);
+#endif
+}
+
+io_registration::~io_registration() noexcept {
+    if (auto entry = io_registry().find(sd))
+        entry->store(nullptr, memory_order_release);
+    if (ep == nullptr)
+        return;
+    epoll_event req{};
+    epoll_ctl(ep->fd(), EPOLL_CTL_DEL, sd, &req); // EBADF if already closed
+}
+
+io_registration* io_registration::find(int64_t sd) noexcept {
+    auto entry = io_registry().find(sd);
+    return entry ? entry->load(memory_order_acquire) : nullptr;
+}
+
+bool io_registration::park(bool output, coroutine_handle<void> coro) noexcept {
+    auto& slot = output ? outbound : inbound;
+    void* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, coro.address(),
+                                     memory_order_acq_rel))
+        return true;
+    // `ready_marker`. the following operation will see all edges until now
+    slot.exchange(nullptr, memory_order_acq_rel);
+    return false;
+}
+
+bool io_registration::cancel(bool output, coroutine_handle<void> coro) noexcept {
+    auto& slot = output ? outbound : inbound;
+    void* expected = coro.address();
+    return slot.compare_exchange_strong(expected, nullptr, memory_order_acq_rel);
+}
+
+void io_registration::keep(bool output) noexcept {
+    auto& slot = output ? outbound : inbound;
+    void* expected = nullptr;
+    // if failed, the slot is already ready with the new edge
+    slot.compare_exchange_strong(expected, ready_marker, memory_order_acq_rel);
+}
+
+ptrdiff_t io_registration::notify(uint32_t events) noexcept(false) {
+    // keep the readiness. the resumed one will consume it with the next `park`
+    void* in = nullptr;
+    void* out = nullptr;
+    // the error will be reported by the operation
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        in = inbound.exchange(ready_marker, memory_order_acq_rel);
+    if (events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+        out = outbound.exchange(ready_marker, memory_order_acq_rel);
+    // `this` can be destroyed after the resume
+    ptrdiff_t count = 0;
+    for (void* ptr : {in, out}) {
+        if (ptr == nullptr || ptr == ready_marker)
+            continue;
+        count += io_deadline_t::resume(coroutine_handle<void>::from_address(ptr));
     }
-    // resume outbound coroutines
+    return count;
+}
+
+#if defined(COROUTINE_USE_IO_URING)
+/// @brief `user_data` tag for `IORING_OP_POLL_ADD`. `io_work_t` is aligned
+constexpr uint64_t poll_tag = 1;
+
+bool io_poller_t::complete(const io_uring_cqe& cqe) noexcept(false) {
+    if (cqe.user_data == 0) // `IORING_OP_LINK_TIMEOUT` of `with_timeout`
+        return false;
+    auto* work = reinterpret_cast<io_work_t*>(cqe.user_data & ~poll_tag);
+    if (cqe.user_data & poll_tag)
+        // readiness only. `resume` will perform the operation
+        set_error(*work, cqe.res < 0 ? -cqe.res : 0);
+    else
+        // the operation is done. `resume` will return the result
+        work->internal_high = static_cast<uint64_t>(static_cast<int64_t>(cqe.res));
+    return io_deadline_t::resume(work->task);
+}
+
+/**
+ * @brief Wait for the readiness of the socket with `IORING_OP_POLL_ADD`
+ * @note  `sendto`/`recvfrom` requires `msghdr` which can't be in `io_work_t`.
+ *        The datagram operations use this instead of `IORING_OP_SENDMSG`/`IORING_OP_RECVMSG`
+ */
+void submit_poll(io_work_t& work, uint32_t events) noexcept(false) {
+    current_poller().prepare(work, [&work, events](io_uring_sqe& sqe) {
+        sqe.opcode = IORING_OP_POLL_ADD;
+        sqe.fd = socket_of(work);
+        sqe.poll32_events = events;
+        sqe.user_data = reinterpret_cast<uint64_t>(&work) | poll_tag;
+    });
+}
+
+/**
+ * @brief Request `IORING_OP_SEND`/`IORING_OP_RECV` with the buffer of the work
+ */
+void submit_transfer(io_work_t& work, uint8_t opcode, uint32_t flag) noexcept(false) {
+    current_poller().prepare(work, [&work, opcode, flag](io_uring_sqe& sqe) {
+        sqe.opcode = opcode;
+        sqe.fd = socket_of(work);
+        sqe.addr = reinterpret_cast<uint64_t>(work.buffer.data());
+        sqe.len = gsl::narrow_cast<uint32_t>(work.buffer.size_bytes());
+        sqe.msg_flags = flag;
+        sqe.user_data = reinterpret_cast<uint64_t>(&work);
+    });
+}
+
+/**
+ * @brief Request `IORING_OP_SENDMSG`/`IORING_OP_RECVMSG` with the `msghdr` of the work
+ */
+void submit_message(io_work_t& work, uint8_t opcode) noexcept(false) {
+    current_poller().prepare(work, [&work, opcode](io_uring_sqe& sqe) {
+        sqe.opcode = opcode;
+        sqe.fd = socket_of(work);
+        sqe.addr = reinterpret_cast<uint64_t>(work.ptr);
+        sqe.len = 1;
+        sqe.msg_flags = flag_of(work);
+        sqe.user_data = reinterpret_cast<uint64_t>(&work);
+    });
+}
+
+/**
+ * @return int64_t The result of the operation from the CQE. `-1` if failed
+ */
+int64_t transfer_result(io_work_t& work) noexcept {
+    const auto sz = static_cast<int64_t>(work.internal_high);
+    set_error(work, sz < 0 ? gsl::narrow_cast<uint32_t>(-sz) : 0);
+    return sz < 0 ? -1 : sz;
+}
+#endif
+
+io_context::io_context(uint32_t concurrency, uint32_t capacity) noexcept(false)
+    : workers{}, stopped{false}, next{0} {
+    concurrency = std::max(concurrency, 1u);
+    workers.reserve(concurrency);
+    for (auto i = 0u; i < concurrency; ++i)
+        workers.emplace_back(make_unique<worker_t>(capacity));
+}
+
+io_context::~io_context() noexcept {
+    stop();
+}
+
+uint32_t io_context::concurrency() const noexcept {
+    return gsl::narrow_cast<uint32_t>(workers.size());
+}
+
+bool io_context::is_stopped() const noexcept {
+    return stopped.load(memory_order_acquire);
+}
+
+void io_context::stop() noexcept {
+    stopped.store(true, memory_order_release);
+    for (auto& w : workers)
+        eventfd_write(w->efd, 1); // wake up to see the flag
+}
+
+void io_context::post(coroutine_handle<void> coro) noexcept(false) {
+    for (auto& w : workers)
+        if (w.get() == current_worker) // keep the coroutine in this thread
+            return w->push(coro);
+    const auto i = next.fetch_add(1, memory_order_relaxed) % workers.size();
+    return workers[i]->push(coro);
+}
+
+void io_context::run() noexcept(false) {
+    stopped.store(false, memory_order_release);
+    std::mutex mtx{};
+    std::exception_ptr failure = nullptr; // the first one from the workers
+    auto loop = [this, &mtx, &failure](worker_t* w) noexcept {
+        current_worker = w;
+        auto on_return = gsl::finally([]() { current_worker = nullptr; });
+        try {
+            while (is_stopped() == false)
+                // the eventfd will wake up the worker. the timeout is a fallback
+                w->poller.poll(1'000, w, [w]() { w->drain(); });
+        } catch (...) {
+            {
+                unique_lock lck{mtx};
+                if (failure == nullptr)
+                    failure = std::current_exception();
+            }
+            stop(); // the other workers must return too
+        }
+    };
     {
-        auto count = oep.wait(half_time.count(), {buf.get(), buf_sz});
-        for (auto i = 0u; i < count; ++i)
-            if (auto coro =
-                    coroutine_handle<void>::from_address(buf[i].data.ptr))
-                coro.resume();
+        std::vector<std::thread> threads{};
+        threads.reserve(workers.size() - 1);
+        auto on_return = gsl::finally([this, &threads]() {
+            stop();
+            for (auto& t : threads)
+                t.join();
+        });
+        for (auto i = 1u; i < workers.size(); ++i)
+            threads.emplace_back(loop, workers[i].get());
+        loop(workers[0].get());
+    }
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+int64_t perform_send_to(io_work_t& work) noexcept {
+    auto addr = reinterpret_cast<sockaddr*>(work.ptr);
+    auto addrlen = static_cast<socklen_t>(work.internal_high);
+    auto sz = sendto(socket_of(work), work.buffer.data(), work.buffer.size_bytes(), //
+                     0, addr, addrlen);
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+int64_t perform_recv_from(io_work_t& work) noexcept {
+    auto addr = reinterpret_cast<sockaddr*>(work.ptr);
+    auto addrlen = static_cast<socklen_t>(work.internal_high);
+    auto sz = recvfrom(socket_of(work), work.buffer.data(), work.buffer.size_bytes(), //
+                       0, addr, addressof(addrlen));
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+int64_t perform_send(io_work_t& work) noexcept {
+    auto sz = send(socket_of(work), work.buffer.data(), work.buffer.size_bytes(),
+                   flag_of(work));
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+int64_t perform_recv(io_work_t& work) noexcept {
+    auto sz = recv(socket_of(work), work.buffer.data(), work.buffer.size_bytes(),
+                   flag_of(work));
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+int64_t perform_send_msg(io_work_t& work) noexcept {
+    auto msg = reinterpret_cast<const msghdr*>(work.ptr);
+    auto sz = sendmsg(socket_of(work), msg, flag_of(work));
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+int64_t perform_recv_msg(io_work_t& work) noexcept {
+    auto msg = reinterpret_cast<msghdr*>(work.ptr);
+    auto sz = recvmsg(socket_of(work), msg, flag_of(work));
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+/// @note `internal_high` is the number of the messages
+int64_t perform_send_mmsg(io_work_t& work) noexcept {
+    auto msgs = reinterpret_cast<mmsghdr*>(work.ptr);
+    auto count = sendmmsg(socket_of(work), msgs,
+                          static_cast<uint32_t>(work.internal_high), flag_of(work));
+    // update error code upon i/o failure
+    set_error(work, count < 0 ? errno : 0);
+    return count;
+}
+
+/// @note `internal_high` is the number of the messages
+int64_t perform_recv_mmsg(io_work_t& work) noexcept {
+    auto msgs = reinterpret_cast<mmsghdr*>(work.ptr);
+    auto count = recvmmsg(socket_of(work), msgs,
+                          static_cast<uint32_t>(work.internal_high), //
+                          static_cast<int>(flag_of(work)), nullptr);
+    // update error code upon i/o failure
+    set_error(work, count < 0 ? errno : 0);
+    return count;
+}
+
+/// @note `internal_high` is the length of the address
+int64_t perform_accept(io_work_t& work) noexcept {
+    auto addr = reinterpret_cast<sockaddr*>(work.ptr);
+    auto addrlen = static_cast<socklen_t>(work.internal_high);
+    auto sd = accept4(socket_of(work), addr, addressof(addrlen),
+                      SOCK_NONBLOCK | SOCK_CLOEXEC);
+    // update error code upon i/o failure
+    set_error(work, sd < 0 ? errno : 0);
+    return sd;
+}
+
+/**
+ * @brief Accept until `EAGAIN` or the output is full
+ * @note  `internal_high` is the number of the output.
+ *        For the blocking socket, only 1 because the next one will block
+ */
+int64_t perform_accept_many(io_work_t& work) noexcept {
+    auto sds = reinterpret_cast<int64_t*>(work.ptr);
+    const auto limit = (work.handle & mode_blocking) ? 1 : work.internal_high;
+    uint64_t count = 0;
+    for (; count < limit; ++count) {
+        const auto sd = accept4(socket_of(work), nullptr, nullptr,
+                                SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (sd < 0)
+            break;
+        sds[count] = sd;
+    }
+    // report the error only if nothing is accepted. the next one will see it again
+    set_error(work, count == 0 ? errno : 0);
+    return count == 0 ? -1 : static_cast<int64_t>(count);
+}
+
+/**
+ * @note `internal_high` is the length of the address.
+ *       Repeated `connect` reports the result of the previous one
+ */
+int64_t perform_connect(io_work_t& work) noexcept {
+    auto addr = reinterpret_cast<const sockaddr*>(work.ptr);
+    auto addrlen = static_cast<socklen_t>(work.internal_high);
+    const auto sd = socket_of(work);
+    // the pending connect may have failed. `connect` will restart it
+    int ec = 0;
+    socklen_t eclen = sizeof(ec);
+    if (getsockopt(sd, SOL_SOCKET, SO_ERROR, &ec, &eclen) == 0 && ec) {
+        set_error(work, static_cast<uint32_t>(ec));
+        return -1;
+    }
+    if (connect(sd, addr, addrlen) == 0) {
+        set_error(work, 0);
+        return 0;
+    }
+    switch (const auto ec = errno) {
+    case EISCONN: // connected with the previous one
+        set_error(work, 0);
+        return 0;
+    case EINPROGRESS:
+    case EALREADY:
+        set_error(work, EAGAIN); // wait for `EPOLLOUT`
+        return -1;
+    default:
+        set_error(work, ec);
+        return -1;
     }
 }
 
-bool io_work_t::ready() const noexcept {
-    auto sd = this->handle;
-    // non blocking operation is expected going to suspend
-    if (fcntl(sd, F_GETFL, 0) & O_NONBLOCK)
+/**
+ * @note `internal_high` is the number of bytes. The file is in the flag of `internal`
+ *       `ptr` is the offset of the caller
+ */
+int64_t perform_send_file(io_work_t& work) noexcept {
+    auto offset = reinterpret_cast<int64_t*>(work.ptr);
+    off_t position = *offset;
+    auto sz = sendfile(socket_of(work), static_cast<int32_t>(flag_of(work)),
+                       addressof(position), work.internal_high);
+    *offset = position;
+    // update error code upon i/o failure
+    set_error(work, sz < 0 ? errno : 0);
+    return sz;
+}
+
+/**
+ * @brief Drain the zero-copy notifications in the error queue
+ * @return int64_t The end of the completed range. `-1` with `EAGAIN` if nothing is completed
+ * @note  For the blocking socket, wait for `POLLERR` because `MSG_ERRQUEUE` doesn't block
+ */
+int64_t perform_recv_zerocopy(io_work_t& work) noexcept {
+    const auto sd = socket_of(work);
+    if (work.handle & mode_blocking) {
+        pollfd fds{sd, POLLERR, 0};
+        while (poll(&fds, 1, -1) < 0 && errno == EINTR)
+            continue;
+    }
+    int64_t completed = -1;
+    auto ec = 0;
+    while (true) {
+        // `sock_extended_err` with the offender address
+        alignas(cmsghdr) array<byte, 128> control{};
+        msghdr msg{};
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        if (recvmsg(sd, &msg, MSG_ERRQUEUE) < 0) {
+            ec = errno;
+            break;
+        }
+        for (auto cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) &&
+                !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+                continue;
+            auto err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cm));
+            // the other errors are not for the zero-copy
+            if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+            // [ee_info, ee_data] are done. `SO_EE_CODE_ZEROCOPY_COPIED` is also a completion
+            completed = max<int64_t>(completed, int64_t{err->ee_data} + 1);
+        }
+    }
+    // report the error only if nothing is completed
+    set_error(work, completed < 0 ? ec : 0);
+    return completed;
+}
+
+/// @brief The operation for the `io_state_t` of the work
+int64_t perform(io_work_t& work) noexcept {
+    switch (work.handle & op_mask) {
+    case op_send_to:
+        return perform_send_to(work);
+    case op_recv_from:
+        return perform_recv_from(work);
+    case op_send:
+        return perform_send(work);
+    case op_recv:
+        return perform_recv(work);
+    case op_send_msg:
+        return perform_send_msg(work);
+    case op_recv_msg:
+        return perform_recv_msg(work);
+    case op_send_mmsg:
+        return perform_send_mmsg(work);
+    case op_recv_mmsg:
+        return perform_recv_mmsg(work);
+    case op_accept:
+        return perform_accept(work);
+    case op_accept_many:
+        return perform_accept_many(work);
+    case op_connect:
+        return perform_connect(work);
+    case op_send_file:
+        return perform_send_file(work);
+    default:
+        return perform_recv_zerocopy(work);
+    }
+}
+
+bool io_work_t::ready() noexcept {
+#if defined(COROUTINE_USE_IO_URING)
+    // the ring will perform the operation without blocking the thread
+    if (this->handle & mode_blocking)
         return false;
-    // not configured. return `true` and bypass to the blocking I/O
+#endif
+    // try once. most of them are ready in the busy server.
+    // for the blocking socket, this is the blocking I/O
+    const auto sz = perform(*this);
+    if (sz < 0 && error() == EAGAIN) {
+        if ((this->handle & mode_blocking) == 0)
+            return false;
+        // the cached mode is stale. `O_NONBLOCK` is set after the `bind_socket`
+        // or the descriptor is reused. `SO_RCVTIMEO` also reports `EAGAIN`
+        const auto mode = query_mode(socket_of(*this));
+        if (mode == mode_nonblocking) {
+            this->handle = (this->handle & ~static_cast<int64_t>(mode_mask)) | mode;
+            return false;
+        }
+    }
+    set_result(*this, sz);
     return true;
 }
 
@@ -50,9 +878,55 @@ uint32_t io_work_t::error() const noexcept {
     return gsl::narrow_cast<uint32_t>(this->internal);
 }
 
+/**
+ * @brief Perform the operation for the readiness of `io_registration`
+ * @return true  The coroutine is parked. `resume` will perform the operation
+ * @return false The operation is done without `EAGAIN`. `resume` will return its result
+ */
+bool park_or_perform(io_registration& reg, bool outbound, io_work_t& work,
+                     coroutine_handle<void> coro) noexcept {
+    // the coroutine can be resumed in the other thread right after the `park`
+    work.task = coro;
+    while (reg.park(outbound, coro) == false) {
+        const auto sz = perform(work);
+        if (sz < 0 && work.error() == EAGAIN)
+            continue; // the readiness is already consumed by the previous one
+        // not blocked. the socket may be still ready for the next one
+        reg.keep(outbound);
+        set_result(work, sz);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Wait for the readiness of the socket in the current poller
+ * @param outbound `true` for `EPOLLOUT`. `false` for `EPOLLIN`
+ * @param events   The events to wait instead of the direction's default
+ * @return false The operation is done without suspension. see `park_or_perform`
+ * @throw system_error
+ */
+bool wait_readiness(io_work_t& work, coroutine_handle<void> coro,
+                    bool outbound, uint32_t events = 0) noexcept(false) {
+    const auto sd = socket_of(work);
+    if (auto reg = io_registration::find(sd))
+        return park_or_perform(*reg, outbound, work, coro);
+
+    epoll_event req{};
+    if (events == 0)
+        events = outbound ? EPOLLOUT : EPOLLIN;
+    req.events = events | EPOLLONESHOT | EPOLLET;
+    req.data.ptr = coro.address();
+
+    auto& poller = current_poller();
+    auto& ep = outbound ? poller.outbound : poller.inbound;
+    ep.try_add(sd, req); // throws if epoll_ctl fails
+    return true;
+}
+
 auto send_to(uint64_t sd, const sockaddr_in& remote, io_buffer_t buffer,
              io_work_t& work) noexcept(false) -> io_send_to& {
-    work.handle = sd;
+    bind_socket(work, sd, op_send_to);
     work.ptr = const_cast<sockaddr_in*>(addressof(remote));
     work.internal_high = sizeof(sockaddr_in);
     work.buffer = buffer;
@@ -61,40 +935,36 @@ auto send_to(uint64_t sd, const sockaddr_in& remote, io_buffer_t buffer,
 
 auto send_to(uint64_t sd, const sockaddr_in6& remote, io_buffer_t buffer,
              io_work_t& work) noexcept(false) -> io_send_to& {
-    work.handle = sd;
+    bind_socket(work, sd, op_send_to);
     work.ptr = const_cast<sockaddr_in6*>(addressof(remote));
     work.internal_high = sizeof(sockaddr_in6);
     work.buffer = buffer;
     return *reinterpret_cast<io_send_to*>(addressof(work));
 }
 
-void io_send_to::suspend(coroutine_handle<void> coro) noexcept(false) {
-    auto sd = this->handle;
-    auto& errc = this->internal;
-    errc = 0;
-
-    epoll_event req{};
-    req.events = EPOLLOUT | EPOLLONESHOT | EPOLLET;
-    req.data.ptr = coro.address();
-
-    oep.try_add(sd, req); // throws if epoll_ctl fails
+bool io_send_to::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_poll(*this, POLLOUT);
+    return true;
+#endif
+    return wait_readiness(*this, coro, true);
 }
 
 int64_t io_send_to::resume() noexcept {
-    auto sd = this->handle;
-    auto addr = reinterpret_cast<sockaddr*>(this->ptr);
-    auto addrlen = static_cast<socklen_t>(this->internal_high);
-    auto& errc = this->internal;
-    auto sz = sendto(sd, buffer.data(), buffer.size_bytes(), //
-                     0, addr, addrlen);
-    // update error code upon i/o failure
-    errc = sz < 0 ? errno : 0;
-    return sz;
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_send_to(*this);
 }
 
 auto recv_from(uint64_t sd, sockaddr_in& remote, io_buffer_t buffer,
                io_work_t& work) noexcept(false) -> io_recv_from& {
-    work.handle = sd;
+    bind_socket(work, sd, op_recv_from);
     work.ptr = addressof(remote);
     work.internal_high = sizeof(sockaddr_in);
     work.buffer = buffer;
@@ -103,97 +973,490 @@ auto recv_from(uint64_t sd, sockaddr_in& remote, io_buffer_t buffer,
 
 auto recv_from(uint64_t sd, sockaddr_in6& remote, io_buffer_t buffer,
                io_work_t& work) noexcept(false) -> io_recv_from& {
-    work.handle = sd;
+    bind_socket(work, sd, op_recv_from);
     work.ptr = addressof(remote);
     work.internal_high = sizeof(sockaddr_in6);
     work.buffer = buffer;
     return *reinterpret_cast<io_recv_from*>(addressof(work));
 }
 
-void io_recv_from::suspend(coroutine_handle<void> coro) noexcept(false) {
-    auto sd = this->handle;
-    auto& errc = this->internal;
-    errc = 0;
-
-    epoll_event req{};
-    req.events = EPOLLIN | EPOLLONESHOT | EPOLLET;
-    req.data.ptr = coro.address();
-
-    iep.try_add(sd, req); // throws if epoll_ctl fails
+bool io_recv_from::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_poll(*this, POLLIN);
+    return true;
+#endif
+    return wait_readiness(*this, coro, false);
 }
 
 int64_t io_recv_from::resume() noexcept {
-    auto sd = this->handle;
-    auto addr = reinterpret_cast<sockaddr*>(this->ptr);
-    auto addrlen = static_cast<socklen_t>(this->internal_high);
-    auto& errc = this->internal;
-    auto sz = recvfrom(sd, buffer.data(), buffer.size_bytes(), //
-                       0, addr, addressof(addrlen));
-    // update error code upon i/o failure
-    errc = sz < 0 ? errno : 0;
-    return sz;
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_recv_from(*this);
 }
 
 auto send_stream(uint64_t sd, io_buffer_t buffer, uint32_t flag,
                  io_work_t& work) noexcept(false) -> io_send& {
     static_assert(sizeof(socklen_t) == sizeof(uint32_t));
-    work.handle = sd;
-    work.internal = flag;
+    bind_socket(work, sd, op_send);
+    work.internal = static_cast<uint64_t>(flag) << 32;
     work.buffer = buffer;
     return *reinterpret_cast<io_send*>(addressof(work));
 }
 
-void io_send::suspend(coroutine_handle<void> coro) noexcept(false) {
-    auto sd = this->handle;
-    auto& errc = this->internal;
-    errc = 0;
-
-    epoll_event req{};
-    req.events = EPOLLOUT | EPOLLONESHOT | EPOLLET;
-    req.data.ptr = coro.address();
-
-    oep.try_add(sd, req); // throws if epoll_ctl fails
+bool io_send::suspend(coroutine_handle<void> coro) noexcept(false) {
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_transfer(*this, IORING_OP_SEND, flag_of(*this));
+    return true;
+#endif
+    return wait_readiness(*this, coro, true);
 }
 
 int64_t io_send::resume() noexcept {
-    auto sd = this->handle;
-    auto flag = this->internal;
-    auto& errc = this->internal;
-    const auto sz = send(sd, buffer.data(), buffer.size_bytes(), flag);
-    // update error code upon i/o failure
-    errc = sz < 0 ? errno : 0;
-    return sz;
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    return transfer_result(*this);
+#endif
+    return perform_send(*this);
 }
 
 auto recv_stream(uint64_t sd, io_buffer_t buffer, uint32_t flag,
                  io_work_t& work) noexcept(false) -> io_recv& {
     static_assert(sizeof(socklen_t) == sizeof(uint32_t));
-    work.handle = sd;
-    work.internal = flag;
+    bind_socket(work, sd, op_recv);
+    work.internal = static_cast<uint64_t>(flag) << 32;
     work.buffer = buffer;
     return *reinterpret_cast<io_recv*>(addressof(work));
 }
 
-void io_recv::suspend(coroutine_handle<void> coro) noexcept(false) {
-    auto sd = this->handle;
-    auto& errc = this->internal;
-    errc = 0;
+bool io_recv::suspend(coroutine_handle<void> coro) noexcept(false) {
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_transfer(*this, IORING_OP_RECV, flag_of(*this));
+    return true;
+#endif
+    return wait_readiness(*this, coro, false);
+}
 
-    epoll_event req{};
-    req.events = EPOLLIN | EPOLLONESHOT | EPOLLET;
-    req.data.ptr = coro.address();
+int64_t io_recv::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    return transfer_result(*this);
+#endif
+    return perform_recv(*this);
+}
 
-    iep.try_add(sd, req);
+auto send_msg(uint64_t sd, const msghdr& msg, uint32_t flag,
+              io_work_t& work) noexcept(false) -> io_send_msg& {
+    bind_socket(work, sd, op_send_msg);
+    work.ptr = const_cast<msghdr*>(addressof(msg));
+    work.internal = static_cast<uint64_t>(flag) << 32;
+    work.buffer = {};
+    return *reinterpret_cast<io_send_msg*>(addressof(work));
 }
 
-int64_t io_recv::resume() noexcept {
-    auto sd = this->handle;
-    auto flag = this->internal;
-    auto& errc = this->internal;
-    const auto sz = recv(sd, buffer.data(), buffer.size_bytes(), flag);
-    // update error code upon i/o failure
-    errc = sz < 0 ? errno : 0;
-    return sz;
+bool io_send_msg::suspend(coroutine_handle<void> coro) noexcept(false) {
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_message(*this, IORING_OP_SENDMSG);
+    return true;
+#endif
+    return wait_readiness(*this, coro, true);
+}
+
+int64_t io_send_msg::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    return transfer_result(*this);
+#endif
+    return perform_send_msg(*this);
+}
+
+auto recv_msg(uint64_t sd, msghdr& msg, uint32_t flag,
+              io_work_t& work) noexcept(false) -> io_recv_msg& {
+    bind_socket(work, sd, op_recv_msg);
+    work.ptr = addressof(msg);
+    work.internal = static_cast<uint64_t>(flag) << 32;
+    work.buffer = {};
+    return *reinterpret_cast<io_recv_msg*>(addressof(work));
+}
+
+bool io_recv_msg::suspend(coroutine_handle<void> coro) noexcept(false) {
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_message(*this, IORING_OP_RECVMSG);
+    return true;
+#endif
+    return wait_readiness(*this, coro, false);
+}
+
+int64_t io_recv_msg::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    return transfer_result(*this);
+#endif
+    return perform_recv_msg(*this);
+}
+
+auto send_mmsg(uint64_t sd, gsl::span<mmsghdr> msgs, uint32_t flag,
+               io_work_t& work) noexcept(false) -> io_send_mmsg& {
+    bind_socket(work, sd, op_send_mmsg);
+    work.ptr = msgs.data();
+    work.internal = static_cast<uint64_t>(flag) << 32;
+    work.internal_high = msgs.size();
+    work.buffer = {};
+    return *reinterpret_cast<io_send_mmsg*>(addressof(work));
+}
+
+bool io_send_mmsg::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    // there is no opcode for `sendmmsg`
+    this->task = coro;
+    submit_poll(*this, POLLOUT);
+    return true;
+#endif
+    return wait_readiness(*this, coro, true);
+}
+
+int64_t io_send_mmsg::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_send_mmsg(*this);
+}
+
+auto recv_mmsg(uint64_t sd, gsl::span<mmsghdr> msgs, uint32_t flag,
+               io_work_t& work) noexcept(false) -> io_recv_mmsg& {
+    bind_socket(work, sd, op_recv_mmsg);
+    work.ptr = msgs.data();
+    work.internal = static_cast<uint64_t>(flag) << 32;
+    work.internal_high = msgs.size();
+    work.buffer = {};
+    return *reinterpret_cast<io_recv_mmsg*>(addressof(work));
+}
+
+bool io_recv_mmsg::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    // there is no opcode for `recvmmsg`
+    this->task = coro;
+    submit_poll(*this, POLLIN);
+    return true;
+#endif
+    return wait_readiness(*this, coro, false);
+}
+
+int64_t io_recv_mmsg::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_recv_mmsg(*this);
+}
+
+auto accept_stream(uint64_t ln, sockaddr_in& remote,
+                   io_work_t& work) noexcept(false) -> io_accept& {
+    bind_socket(work, ln, op_accept);
+    work.ptr = addressof(remote);
+    work.internal_high = sizeof(sockaddr_in);
+    work.buffer = {};
+    return *reinterpret_cast<io_accept*>(addressof(work));
+}
+
+auto accept_stream(uint64_t ln, sockaddr_in6& remote,
+                   io_work_t& work) noexcept(false) -> io_accept& {
+    bind_socket(work, ln, op_accept);
+    work.ptr = addressof(remote);
+    work.internal_high = sizeof(sockaddr_in6);
+    work.buffer = {};
+    return *reinterpret_cast<io_accept*>(addressof(work));
+}
+
+auto accept_streams(uint64_t ln, gsl::span<int64_t> sds,
+                    io_work_t& work) noexcept(false) -> io_accept& {
+    bind_socket(work, ln, op_accept_many);
+    work.ptr = sds.data();
+    work.internal_high = sds.size();
+    work.buffer = {};
+    return *reinterpret_cast<io_accept*>(addressof(work));
+}
+
+bool io_accept::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    // `IORING_OP_ACCEPT` can't drain the backlog
+    this->task = coro;
+    submit_poll(*this, POLLIN);
+    return true;
+#endif
+    return wait_readiness(*this, coro, false);
+}
+
+int64_t io_accept::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform(*this);
+}
+
+auto connect_stream(uint64_t sd, const sockaddr_in& remote,
+                    io_work_t& work) noexcept(false) -> io_connect& {
+    bind_socket(work, sd, op_connect);
+    work.ptr = const_cast<sockaddr_in*>(addressof(remote));
+    work.internal_high = sizeof(sockaddr_in);
+    work.buffer = {};
+    return *reinterpret_cast<io_connect*>(addressof(work));
+}
+
+auto connect_stream(uint64_t sd, const sockaddr_in6& remote,
+                    io_work_t& work) noexcept(false) -> io_connect& {
+    bind_socket(work, sd, op_connect);
+    work.ptr = const_cast<sockaddr_in6*>(addressof(remote));
+    work.internal_high = sizeof(sockaddr_in6);
+    work.buffer = {};
+    return *reinterpret_cast<io_connect*>(addressof(work));
+}
+
+bool io_connect::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_poll(*this, POLLOUT);
+    return true;
+#endif
+    return wait_readiness(*this, coro, true);
+}
+
+int64_t io_connect::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_connect(*this);
+}
+
+auto send_file(uint64_t sd, int64_t fd, int64_t& offset, size_t count,
+               io_work_t& work) noexcept(false) -> io_send_file& {
+    static_assert(sizeof(off_t) == sizeof(int64_t));
+    bind_socket(work, sd, op_send_file);
+    work.internal = static_cast<uint64_t>(fd) << 32;
+    work.ptr = addressof(offset);
+    work.internal_high = count;
+    work.buffer = {};
+    return *reinterpret_cast<io_send_file*>(addressof(work));
+}
+
+bool io_send_file::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    // there is no opcode for `sendfile`
+    this->task = coro;
+    submit_poll(*this, POLLOUT);
+    return true;
+#endif
+    return wait_readiness(*this, coro, true);
+}
+
+int64_t io_send_file::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_send_file(*this);
+}
+
+auto recv_zerocopy(uint64_t sd, io_work_t& work) noexcept(false)
+    -> io_recv_zerocopy& {
+    bind_socket(work, sd, op_recv_zerocopy);
+    work.internal = 0;
+    work.ptr = nullptr;
+    work.internal_high = 0;
+    work.buffer = {};
+    return *reinterpret_cast<io_recv_zerocopy*>(addressof(work));
+}
+
+bool io_recv_zerocopy::suspend(coroutine_handle<void> coro) noexcept(false) {
+    set_error(*this, 0);
+#if defined(COROUTINE_USE_IO_URING)
+    this->task = coro;
+    submit_poll(*this, POLLERR);
+    return true;
+#endif
+    // the notification is for the outbound. but the socket is always writable
+    return wait_readiness(*this, coro, true, EPOLLERR);
+}
+
+int64_t io_recv_zerocopy::resume() noexcept {
+    if (has_result(*this))
+        return static_cast<int64_t>(this->internal_high);
+#if defined(COROUTINE_USE_IO_URING)
+    if (error()) // the poll failed
+        return -1;
+#endif
+    return perform_recv_zerocopy(*this);
+}
+
+/// @brief `CLOCK_MONOTONIC` in nanoseconds. Same clock with the `timerfd`
+int64_t monotonic_now() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
+}
+
+/// @param expiry `0` disarms the timer
+void set_timer(int64_t fd, int64_t expiry) noexcept(false) {
+    itimerspec spec{};
+    spec.it_value.tv_sec = expiry / 1'000'000'000;
+    spec.it_value.tv_nsec = expiry % 1'000'000'000;
+    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr) != 0)
+        throw system_error{errno, system_category(), "timerfd_settime"};
+}
+
+/// @brief The direction which the operation waits for
+bool is_outbound(const io_work_t& work) noexcept {
+    switch (work.handle & op_mask) {
+    case op_recv_from:
+    case op_recv:
+    case op_recv_msg:
+    case op_recv_mmsg:
+    case op_accept:
+    case op_accept_many:
+        return false;
+    default:
+        return true;
+    }
+}
+
+void io_poller_t::schedule(io_deadline_t& d) noexcept(false) {
+    unique_lock lck{tmtx};
+    const auto it = deadlines.emplace(d.expiry, addressof(d)).first;
+    if (it == deadlines.begin())
+        set_timer(tfd, d.expiry);
+}
+
+void io_poller_t::unschedule(io_deadline_t& d) noexcept {
+    unique_lock lck{tmtx};
+    // the timer is not updated. the next `expire` will do
+    deadlines.erase({d.expiry, addressof(d)});
+}
+
+ptrdiff_t io_poller_t::expire() noexcept(false) {
+    uint64_t count = 0;
+    read(tfd, &count, sizeof(count)); // EAGAIN is ok. already consumed
+    std::vector<coroutine_handle<void>> cancelled{};
+    {
+        unique_lock lck{tmtx};
+        const auto now = monotonic_now();
+        while (deadlines.empty() == false) {
+            const auto [expiry, d] = *deadlines.begin();
+            if (expiry > now)
+                break;
+            deadlines.erase(deadlines.begin());
+            if (cancel(*d))
+                cancelled.emplace_back(d->task);
+        }
+        set_timer(tfd, deadlines.empty() ? 0 : deadlines.begin()->first);
+    }
+    for (auto coro : cancelled)
+        coro.resume();
+    return static_cast<ptrdiff_t>(cancelled.size());
+}
+
+bool io_poller_t::cancel(io_deadline_t& d) noexcept {
+    const auto sd = socket_of(d.work);
+    const auto outbound = is_outbound(d.work);
+    auto reg = io_registration::find(sd);
+    // `notify` took the handle if failed. it will claim
+    if (reg && reg->cancel(outbound, d.handle()) == false)
+        return false;
+    const auto prev = d.claim(io_deadline_t::claimed_by_timer);
+    if (prev & (io_deadline_t::claimed_by_io | io_deadline_t::claimed_by_timer))
+        return false;
+    // `EPOLLONESHOT` keeps the socket in the epoll. remove it for the next operation.
+    // the event in the same batch is already dispatched before the `expire`
+    if (reg == nullptr)
+        epoll_ctl((outbound ? this->outbound : inbound).fd(), EPOLL_CTL_DEL, sd, nullptr);
+    return (prev & io_deadline_t::arming) == 0;
+}
+
+uint32_t io_deadline_t::claim(state_t by) noexcept {
+    return state.fetch_or(by, memory_order_acq_rel);
+}
+
+void io_deadline_t::prepare(coroutine_handle<void> coro) noexcept(false) {
+    poller = addressof(current_poller());
+    task = coro;
+    expiry = monotonic_now() + std::max<int64_t>(timeout.count(), 1);
+    spec[0] = expiry / 1'000'000'000;
+    spec[1] = expiry % 1'000'000'000;
+    // the claim will see the fields above
+    state.store(arming, memory_order_release);
+}
+
+bool io_deadline_t::arm() noexcept {
+#if !defined(COROUTINE_USE_IO_URING)
+    static_cast<io_poller_t*>(poller)->schedule(*this);
+#endif
+    // the claims while `arming` left the resume to here
+    const auto prev = state.fetch_and(~arming, memory_order_acq_rel);
+    // if suspended, the deadline can be destroyed after the `fetch_and`
+    return (prev & (claimed_by_io | claimed_by_timer)) == 0;
+}
+
+bool io_deadline_t::disarm() noexcept {
+    if (poller == nullptr) // not suspended
+        return false;
+#if defined(COROUTINE_USE_IO_URING)
+    poller = nullptr;
+    // `IORING_OP_LINK_TIMEOUT` cancelled the operation
+    if (work.error() != ECANCELED &&
+        static_cast<int64_t>(work.internal_high) != -ECANCELED)
+        return false;
+#else
+    static_cast<io_poller_t*>(poller)->unschedule(*this);
+    poller = nullptr;
+    if ((state.load(memory_order_acquire) & claimed_by_timer) == 0)
+        return false;
+#endif
+    set_error(work, ETIMEDOUT);
+    return true;
+}
+
+bool io_deadline_t::resume(coroutine_handle<void> h) noexcept(false) {
+    auto d = from(h);
+    if (d == nullptr) {
+        h.resume();
+        return true;
+    }
+    const auto prev = d->claim(claimed_by_io);
+    // the other one resumes. `d` can be destroyed after the claim
+    if (prev & (arming | claimed_by_io | claimed_by_timer))
+        return false;
+    d->task.resume();
+    return true;
 }
 
 } // namespace coro
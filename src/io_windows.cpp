@@ -10,10 +10,19 @@ using namespace gsl;
 
 namespace coro {
 
-void poll_net_tasks(uint64_t nano) noexcept(false) {
+/// @brief The number of `on_io_done` in the current thread's alertable wait
+thread_local ptrdiff_t resumed_count = 0;
+
+ptrdiff_t poll_net_tasks(uint64_t nano) noexcept(false) {
     using namespace std::chrono;
     const auto ms = duration_cast<milliseconds>(nanoseconds{nano});
+    resumed_count = 0;
     SleepEx(ms.count(), true);
+    return resumed_count;
+}
+
+void set_net_poll_capacity(uint32_t) noexcept(false) {
+    // the completion routines are invoked as APC. there is no buffer
 }
 
 bool is_async_pending(int ec) noexcept {
@@ -41,10 +50,11 @@ void CALLBACK on_io_done(DWORD errc, DWORD sz, LPWSAOVERLAPPED pover,
     work->Internal = errc;   // -> return of `work.error()`
     work->InternalHigh = sz; // -> return of `work.resume()`
     assert(static_cast<bool>(work->task));
+    ++resumed_count;
     work->task.resume();
 }
 
-bool io_work_t::ready() const noexcept {
+bool io_work_t::ready() noexcept {
     return false; // always trigger `await_suspend` in Windows API
 }
 
@@ -112,7 +122,7 @@ auto send_to(uint64_t sd, const sockaddr_in& remote, io_buffer_t buffer,
 
 GSL_SUPPRESS(type .1)
 GSL_SUPPRESS(bounds .3)
-void io_send_to::suspend(coroutine_handle<void> t) noexcept(false) {
+bool io_send_to::suspend(coroutine_handle<void> t) noexcept(false) {
     task = t; // coroutine will be resumed in overlapped callback
 
     const auto sd = reinterpret_cast<SOCKET>(hEvent);
@@ -125,14 +135,15 @@ void io_send_to::suspend(coroutine_handle<void> t) noexcept(false) {
     if (::WSASendTo(sd, bufs, 1, nullptr, flag, //
                     addr, addrlen,              //
                     p, on_io_done) == NO_ERROR)
-        return;
+        return true;
 
     if (const auto ec = WSAGetLastError()) {
         if (is_async_pending(ec))
-            return;
+            return true;
 
         throw system_error{ec, system_category(), "WSASendTo"};
     }
+    return true;
 }
 
 int64_t io_send_to::resume() noexcept {
@@ -169,7 +180,7 @@ auto recv_from(uint64_t sd, sockaddr_in& remote, io_buffer_t buffer,
 
 GSL_SUPPRESS(type .1)
 GSL_SUPPRESS(bounds .3)
-void io_recv_from::suspend(coroutine_handle<void> t) noexcept(false) {
+bool io_recv_from::suspend(coroutine_handle<void> t) noexcept(false) {
     task = t; // coroutine will be resumed in overlapped callback
 
     const auto sd = reinterpret_cast<SOCKET>(hEvent);
@@ -182,14 +193,15 @@ void io_recv_from::suspend(coroutine_handle<void> t) noexcept(false) {
     if (::WSARecvFrom(sd, bufs, 1, nullptr, &flag, //
                       addr, &addrlen,              //
                       p, on_io_done) == NO_ERROR)
-        return;
+        return true;
 
     if (const auto ec = WSAGetLastError()) {
         if (is_async_pending(ec))
-            return;
+            return true;
 
         throw system_error{ec, system_category(), "WSARecvFrom"};
     }
+    return true;
 }
 
 int64_t io_recv_from::resume() noexcept {
@@ -210,7 +222,7 @@ auto send_stream(uint64_t sd, io_buffer_t buffer, uint32_t flag,
 
 GSL_SUPPRESS(type .1)
 GSL_SUPPRESS(bounds .3)
-void io_send::suspend(coroutine_handle<void> t) noexcept(false) {
+bool io_send::suspend(coroutine_handle<void> t) noexcept(false) {
     task = t; // coroutine will be resumed in overlapped callback
 
     const auto sd = reinterpret_cast<SOCKET>(hEvent);
@@ -219,14 +231,15 @@ void io_send::suspend(coroutine_handle<void> t) noexcept(false) {
 
     if (::WSASend(sd, bufs, 1, nullptr, flag, //
                   zero_overlapped(this), on_io_done) == NO_ERROR)
-        return;
+        return true;
 
     if (const auto ec = WSAGetLastError()) {
         if (is_async_pending(ec))
-            return;
+            return true;
 
         throw system_error{ec, system_category(), "WSASend"};
     }
+    return true;
 }
 
 int64_t io_send::resume() noexcept {
@@ -247,7 +260,7 @@ auto recv_stream(uint64_t sd, io_buffer_t buffer, uint32_t flag,
 
 GSL_SUPPRESS(type .1)
 GSL_SUPPRESS(bounds .3)
-void io_recv::suspend(coroutine_handle<void> t) noexcept(false) {
+bool io_recv::suspend(coroutine_handle<void> t) noexcept(false) {
     task = t; // coroutine will be resumed in overlapped callback
 
     const auto sd = reinterpret_cast<SOCKET>(hEvent);
@@ -256,14 +269,15 @@ void io_recv::suspend(coroutine_handle<void> t) noexcept(false) {
 
     if (::WSARecv(sd, bufs, 1, nullptr, &flag, //
                   zero_overlapped(this), on_io_done) == NO_ERROR)
-        return;
+        return true;
 
     if (const auto ec = WSAGetLastError()) {
         if (is_async_pending(ec))
-            return;
+            return true;
 
         throw system_error{ec, system_category(), "WSARecv"};
     }
+    return true;
 }
 
 int64_t io_recv::resume() noexcept {
@@ -3,8 +3,12 @@
  */
 #include <coroutine/linux.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fcntl.h>
 #include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 using namespace std;
@@ -45,11 +49,128 @@ void epoll_owner::remove(uint64_t fd) {
 ptrdiff_t epoll_owner::wait(uint32_t wait_ms,
                             gsl::span<epoll_event> output) noexcept(false) {
     auto count = epoll_wait(epfd, output.data(), output.size(), wait_ms);
+    if (count == -1 && errno == EINTR) // signal or io_uring's task work
+        return 0;
     if (count == -1)
         throw system_error{errno, system_category(), "epoll_wait"};
     return count;
 }
 
+#if defined(COROUTINE_USE_IO_URING)
+io_uring_owner::io_uring_owner(uint32_t capacity) noexcept(false)
+    : ringfd{-1}, entries{}, pending{}, sq_ring{MAP_FAILED}, sq_ring_size{},
+      cq_ring{MAP_FAILED}, cq_ring_size{}, sqes{}, sq_off{}, cq_off{}, mtx{} {
+    io_uring_params params{};
+    ringfd = syscall(__NR_io_uring_setup, capacity, &params);
+    if (ringfd < 0)
+        throw system_error{errno, system_category(), "io_uring_setup"};
+    auto on_error = gsl::finally([this]() {
+        if (sqes) // the last mmap is done. success
+            return;
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+            munmap(cq_ring, cq_ring_size);
+        if (sq_ring != MAP_FAILED)
+            munmap(sq_ring, sq_ring_size);
+        close(ringfd);
+    });
+    entries = params.sq_entries;
+    sq_off = params.sq_off;
+    cq_off = params.cq_off;
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    // since 5.4, 1 mmap for both SQ and CQ
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ringfd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+        throw system_error{errno, system_category(), "mmap(IORING_OFF_SQ_RING)"};
+    cq_ring = sq_ring;
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+        cq_ring = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ringfd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+            throw system_error{errno, system_category(), "mmap(IORING_OFF_CQ_RING)"};
+    }
+    void* ptr = mmap(nullptr, entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ringfd, IORING_OFF_SQES);
+    if (ptr == MAP_FAILED)
+        throw system_error{errno, system_category(), "mmap(IORING_OFF_SQES)"};
+    sqes = reinterpret_cast<io_uring_sqe*>(ptr);
+}
+
+io_uring_owner::~io_uring_owner() noexcept {
+    munmap(sqes, entries * sizeof(io_uring_sqe));
+    if (cq_ring != sq_ring)
+        munmap(cq_ring, cq_ring_size);
+    munmap(sq_ring, sq_ring_size);
+    close(ringfd);
+}
+
+/// @brief The ring's head/tail are shared with the kernel
+atomic_ref<uint32_t> ring_index(void* ring, uint32_t offset) noexcept {
+    return atomic_ref<uint32_t>{
+        *reinterpret_cast<uint32_t*>(reinterpret_cast<byte*>(ring) + offset)};
+}
+
+io_uring_sqe* io_uring_owner::acquire(uint32_t count) noexcept(false) {
+    const uint32_t tail = ring_index(sq_ring, sq_off.tail).load(memory_order_relaxed);
+    if (tail - ring_index(sq_ring, sq_off.head).load(memory_order_acquire) + count > entries) {
+        // the SQ is full. flush to make a space
+        if (flush() == 0)
+            throw system_error{EBUSY, system_category(), "io_uring_enter"};
+    }
+    const uint32_t mask = ring_index(sq_ring, sq_off.ring_mask).load(memory_order_relaxed);
+    const uint32_t index = tail & mask;
+    auto* array = reinterpret_cast<uint32_t*>(reinterpret_cast<byte*>(sq_ring) + sq_off.array);
+    array[index] = index;
+    io_uring_sqe* sqe = sqes + index;
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    return sqe;
+}
+
+void io_uring_owner::commit() noexcept {
+    auto tail = ring_index(sq_ring, sq_off.tail);
+    tail.store(tail.load(memory_order_relaxed) + 1, memory_order_release);
+    ++pending;
+}
+
+uint32_t io_uring_owner::flush() noexcept(false) {
+    if (pending == 0)
+        return 0;
+    const auto count = syscall(__NR_io_uring_enter, ringfd, pending, 0, 0, nullptr, 0);
+    if (count < 0) {
+        // the kernel is busy. try again with the next submit
+        if (errno == EAGAIN || errno == EBUSY || errno == EINTR)
+            return 0;
+        throw system_error{errno, system_category(), "io_uring_enter"};
+    }
+    pending -= gsl::narrow_cast<uint32_t>(count);
+    return gsl::narrow_cast<uint32_t>(count);
+}
+
+uint32_t io_uring_owner::submit() noexcept(false) {
+    unique_lock lck{mtx};
+    return flush();
+}
+
+ptrdiff_t io_uring_owner::reap(gsl::span<io_uring_cqe> list) noexcept {
+    unique_lock lck{mtx};
+    auto head = ring_index(cq_ring, cq_off.head);
+    const uint32_t tail = ring_index(cq_ring, cq_off.tail).load(memory_order_acquire);
+    const uint32_t mask = ring_index(cq_ring, cq_off.ring_mask).load(memory_order_relaxed);
+    auto* cqes = reinterpret_cast<io_uring_cqe*>(reinterpret_cast<byte*>(cq_ring) + cq_off.cqes);
+
+    uint32_t current = head.load(memory_order_relaxed);
+    ptrdiff_t count = 0;
+    for (; current != tail && count < static_cast<ptrdiff_t>(list.size()); ++count)
+        list[count] = cqes[current++ & mask];
+    head.store(current, memory_order_release);
+    return count;
+}
+#endif // COROUTINE_USE_IO_URING
+
 //
 //  We are going to combine file descriptor and state bit
 //
@@ -1,10 +1,22 @@
 /**
  * @author github.com/luncliff (luncliff@gmail.com)
  */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <coroutine/net.h>
 #include <coroutine/yield.hpp>
 
 using namespace std;
+using namespace std::chrono;
 namespace coro {
 
 GSL_SUPPRESS(type .1)
@@ -89,4 +101,410 @@ uint32_t get_address(const addrinfo& hint, //
     return 0;
 }
 
+/**
+ * @brief 1 entry of the resolver cache. Copied in/out of `cache_slot_t` as words
+ * @note  `expiry` is 0 for the empty entry
+ */
+struct cache_entry_t final {
+    static constexpr size_t max_host = 256; // DNS name is up to 253
+    static constexpr size_t max_serv = NI_MAXSERV;
+    static constexpr size_t max_count = 8;
+
+    uint64_t hash;
+    int64_t expiry; // steady clock in nanoseconds
+    int32_t family, socktype, protocol, flags;
+    uint32_t stride; // `sizeof` the output element
+    uint32_t ec;
+    uint32_t count;
+    uint32_t reserved;
+    char host[max_host];
+    char serv[max_serv];
+    byte addrs[max_count][sizeof(sockaddr_in6)];
+};
+static_assert(sizeof(cache_entry_t) % sizeof(uint64_t) == 0);
+
+/**
+ * @brief Seqlock for 1 entry. The sequence is odd while the writer is updating
+ * @note  The words are atomic so the readers never observe the torn value without the retry
+ */
+struct cache_slot_t final {
+    static constexpr size_t word_count = sizeof(cache_entry_t) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> seq{};
+    std::array<std::atomic<uint64_t>, word_count> words{};
+
+  public:
+    /// @brief Lock-free. `false` if the writer is updating the slot
+    bool load(cache_entry_t& entry) const noexcept {
+        std::array<uint64_t, word_count> buf{};
+        const auto s1 = seq.load(memory_order_acquire);
+        if (s1 & 1)
+            return false;
+        // acquire for each word. the 2nd load of `seq` can't be reordered before them
+        for (auto i = 0u; i < word_count; ++i)
+            buf[i] = words[i].load(memory_order_acquire);
+        if (seq.load(memory_order_relaxed) != s1)
+            return false;
+        memcpy(addressof(entry), buf.data(), sizeof(entry));
+        return true;
+    }
+    /// @note The writers are serialized with the sequence
+    void store(const cache_entry_t& entry) noexcept {
+        std::array<uint64_t, word_count> buf{};
+        memcpy(buf.data(), addressof(entry), sizeof(entry));
+        auto s = seq.load(memory_order_relaxed);
+        while ((s & 1) ||
+               seq.compare_exchange_weak(s, s + 1, memory_order_acquire) == false) {
+            s = seq.load(memory_order_relaxed);
+            this_thread::yield();
+        }
+        // release for each word. the odd sequence is visible before them
+        for (auto i = 0u; i < word_count; ++i)
+            words[i].store(buf[i], memory_order_release);
+        seq.store(s + 2, memory_order_release);
+    }
+    /// @brief The first word of `cache_entry_t` for the quick comparison
+    uint64_t hash() const noexcept {
+        return words[0].load(memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Set-associative cache for `get_address_cached`.
+ *        The key is hashed to a set. The expired(or the earliest) way is replaced
+ */
+class resolver_cache_t final {
+    static constexpr size_t way_count = 4;
+    static constexpr size_t set_count = 64;
+
+    std::array<cache_slot_t, way_count * set_count> slots{};
+    std::atomic<int64_t> positive_ttl{duration_cast<nanoseconds>(30s).count()};
+    std::atomic<int64_t> negative_ttl{duration_cast<nanoseconds>(5s).count()};
+    std::atomic<uint64_t> hit{}, miss{}, eviction{};
+
+  public:
+    static int64_t now() noexcept {
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief Prepare the key part of the entry
+     * @return false The key is too long for the cache
+     */
+    static bool make_key(const addrinfo& hint, gsl::czstring host,
+                         gsl::czstring serv, uint32_t stride,
+                         cache_entry_t& key) noexcept {
+        key = cache_entry_t{};
+        const auto hlen = host ? strlen(host) : 0;
+        const auto slen = serv ? strlen(serv) : 0;
+        if (hlen >= cache_entry_t::max_host || slen >= cache_entry_t::max_serv)
+            return false;
+        if (host)
+            memcpy(key.host, host, hlen);
+        if (serv)
+            memcpy(key.serv, serv, slen);
+        key.family = hint.ai_family;
+        key.socktype = hint.ai_socktype;
+        key.protocol = hint.ai_protocol;
+        key.flags = hint.ai_flags;
+        key.stride = stride;
+        // FNV-1a. `nullptr` and "" are same in the key
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const void* ptr, size_t len) {
+            for (auto p = static_cast<const uint8_t*>(ptr); len; --len, ++p)
+                h = (h ^ *p) * 1099511628211ull;
+        };
+        mix(key.host, hlen + 1);
+        mix(key.serv, slen + 1);
+        mix(addressof(key.family), 5 * sizeof(int32_t));
+        key.hash = h | 1; // 0 is for the empty slot
+        return true;
+    }
+
+    static bool same_key(const cache_entry_t& lhs, const cache_entry_t& rhs) noexcept {
+        return lhs.hash == rhs.hash && lhs.family == rhs.family &&
+               lhs.socktype == rhs.socktype && lhs.protocol == rhs.protocol &&
+               lhs.flags == rhs.flags && lhs.stride == rhs.stride &&
+               strcmp(lhs.host, rhs.host) == 0 && strcmp(lhs.serv, rhs.serv) == 0;
+    }
+
+    bool enabled() const noexcept {
+        return positive_ttl.load(memory_order_relaxed) > 0;
+    }
+
+    /// @brief Find the live entry. The key is overwritten with the entry
+    bool find(cache_entry_t& key) noexcept {
+        const auto t = now();
+        auto set = slots.data() + (key.hash % set_count) * way_count;
+        for (auto i = 0u; i < way_count; ++i) {
+            if (set[i].hash() != key.hash)
+                continue;
+            cache_entry_t entry{};
+            // being updated. treat as a miss
+            if (set[i].load(entry) == false || same_key(entry, key) == false)
+                continue;
+            if (entry.expiry <= t)
+                break;
+            key = entry;
+            hit.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+        miss.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+
+    /// @brief Set the expiry for the result and store the entry
+    void insert(cache_entry_t& entry) noexcept {
+        switch (static_cast<int32_t>(entry.ec)) {
+        case EAI_AGAIN:
+        case EAI_MEMORY:
+#if defined(EAI_SYSTEM)
+        case EAI_SYSTEM:
+#endif
+            return; // temporary. the next one may succeed
+        default:
+            break;
+        }
+        const auto ttl = (entry.ec == 0 ? positive_ttl : negative_ttl)
+                             .load(memory_order_relaxed);
+        if (ttl <= 0)
+            return;
+        const auto t = now();
+        entry.expiry = t + ttl;
+
+        auto set = slots.data() + (entry.hash % set_count) * way_count;
+        cache_slot_t* victim = nullptr;
+        int64_t earliest = numeric_limits<int64_t>::max();
+        for (auto i = 0u; i < way_count; ++i) {
+            cache_entry_t current{};
+            if (set[i].load(current) == false)
+                continue; // the other writer is using it
+            if (current.expiry != 0 && same_key(current, entry)) {
+                victim = addressof(set[i]), earliest = 0; // update in place
+                break;
+            }
+            if (current.expiry < earliest)
+                victim = addressof(set[i]), earliest = current.expiry;
+        }
+        if (victim == nullptr)
+            return;
+        if (earliest > t) // replacing the live entry
+            eviction.fetch_add(1, memory_order_relaxed);
+        victim->store(entry);
+    }
+
+    void clear() noexcept {
+        const cache_entry_t empty{};
+        for (auto& slot : slots)
+            slot.store(empty);
+    }
+    void set_ttl(int64_t positive, int64_t negative) noexcept {
+        positive_ttl.store(positive, memory_order_relaxed);
+        negative_ttl.store(negative, memory_order_relaxed);
+    }
+    auto stats() const noexcept -> resolver_cache_stats_t {
+        return {hit.load(memory_order_relaxed), miss.load(memory_order_relaxed),
+                eviction.load(memory_order_relaxed)};
+    }
+};
+
+resolver_cache_t& resolver_cache() noexcept {
+    static resolver_cache_t cache{};
+    return cache;
+}
+
+/**
+ * @brief Find the entry for the request and copy its addresses to the output
+ * @return false The request is not in the cache
+ */
+template <typename T>
+bool lookup_address(const addrinfo& hint, gsl::czstring host, gsl::czstring serv,
+                    gsl::span<T> output, uint32_t& ec) noexcept {
+    auto& cache = resolver_cache();
+    cache_entry_t entry{};
+    if (cache.enabled() == false ||
+        cache.make_key(hint, host, serv, sizeof(T), entry) == false)
+        return false;
+    if (cache.find(entry) == false)
+        return false;
+    const auto count = std::min<size_t>(entry.count, output.size());
+    for (auto i = 0u; i < count; ++i)
+        memcpy(addressof(output[i]), entry.addrs[i], sizeof(T));
+    ec = entry.ec;
+    return true;
+}
+
+/// @brief `get_address` and insert its result to the cache
+template <typename T>
+uint32_t resolve_and_insert(const addrinfo& hint, gsl::czstring host,
+                            gsl::czstring serv, gsl::span<T> output) noexcept {
+    auto& cache = resolver_cache();
+    cache_entry_t entry{};
+    if (cache.enabled() == false ||
+        cache.make_key(hint, host, serv, sizeof(T), entry) == false)
+        return get_address(hint, host, serv, output);
+
+    std::array<T, cache_entry_t::max_count> addrs{};
+    entry.ec = get_address(hint, host, serv, gsl::span<T>{addrs});
+    for (const auto& addr : addrs) {
+        // the remaining ones are not written
+        if (reinterpret_cast<const sockaddr&>(addr).sa_family == 0)
+            break;
+        memcpy(entry.addrs[entry.count++], addressof(addr), sizeof(T));
+    }
+    const auto count = std::min<size_t>(entry.count, output.size());
+    for (auto i = 0u; i < count; ++i)
+        output[i] = addrs[i];
+    const auto ec = entry.ec;
+    cache.insert(entry);
+    return ec;
+}
+
+uint32_t get_address_cached(const addrinfo& hint, //
+                            gsl::czstring host, gsl::czstring serv,
+                            gsl::span<sockaddr_in> output) noexcept {
+    uint32_t ec = 0;
+    if (lookup_address(hint, host, serv, output, ec))
+        return ec;
+    return resolve_and_insert(hint, host, serv, output);
+}
+
+uint32_t get_address_cached(const addrinfo& hint, //
+                            gsl::czstring host, gsl::czstring serv,
+                            gsl::span<sockaddr_in6> output) noexcept {
+    uint32_t ec = 0;
+    if (lookup_address(hint, host, serv, output, ec))
+        return ec;
+    return resolve_and_insert(hint, host, serv, output);
+}
+
+void set_resolver_cache_ttl(seconds positive, seconds negative) noexcept {
+    resolver_cache().set_ttl(duration_cast<nanoseconds>(positive).count(),
+                             duration_cast<nanoseconds>(negative).count());
+}
+
+void clear_resolver_cache() noexcept {
+    resolver_cache().clear();
+}
+
+auto get_resolver_cache_stats() noexcept -> resolver_cache_stats_t {
+    return resolver_cache().stats();
+}
+
+/**
+ * @brief Threads for the blocking `getaddrinfo`
+ * @note  A thread is spawned when the idle ones are not enough for the queue.
+ *        Up to `io_resolve_t::max_concurrency`
+ */
+class resolver_pool_t final {
+    std::mutex mtx{};
+    std::condition_variable cv{};
+    std::deque<io_resolve_t*> queue{};
+    std::vector<std::thread> threads{};
+    uint32_t idle = 0;
+    bool stopped = false;
+
+  public:
+    ~resolver_pool_t() noexcept {
+        {
+            unique_lock lck{mtx};
+            stopped = true;
+        }
+        cv.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    void push(io_resolve_t* req) noexcept(false) {
+        {
+            unique_lock lck{mtx};
+            queue.push_back(req);
+            // the idle ones might not be woken yet. compare with the queue
+            if (idle < queue.size() &&
+                threads.size() < io_resolve_t::max_concurrency)
+                threads.emplace_back(&resolver_pool_t::run, this);
+        }
+        cv.notify_one();
+    }
+
+  private:
+    void run() noexcept(false) {
+        unique_lock lck{mtx};
+        while (true) {
+            ++idle;
+            cv.wait(lck, [this]() { return stopped || queue.empty() == false; });
+            --idle;
+            if (queue.empty()) // stopped
+                return;
+            auto req = queue.front();
+            queue.pop_front();
+            lck.unlock();
+            req->resolve(); // `req` can be destroyed after this
+            lck.lock();
+        }
+    }
+};
+
+resolver_pool_t& resolver_pool() noexcept(false) {
+    static resolver_pool_t pool{};
+    return pool;
+}
+
+io_resolve_t::io_resolve_t(const addrinfo& _hint, //
+                           gsl::czstring _host, gsl::czstring _serv,
+                           gsl::span<sockaddr_in> output, executor_type fn,
+                           void* ctx) noexcept
+    : hint{_hint}, host{_host}, serv{_serv}, output4{output}, output6{},
+      executor{fn}, context{ctx} {
+}
+
+io_resolve_t::io_resolve_t(const addrinfo& _hint, //
+                           gsl::czstring _host, gsl::czstring _serv,
+                           gsl::span<sockaddr_in6> output, executor_type fn,
+                           void* ctx) noexcept
+    : hint{_hint}, host{_host}, serv{_serv}, output4{}, output6{output},
+      executor{fn}, context{ctx} {
+}
+
+void io_resolve_t::resolve() noexcept(false) {
+    // `await_ready` already counted the miss
+    ec = output6.empty() ? resolve_and_insert(hint, host, serv, output4)
+                         : resolve_and_insert(hint, host, serv, output6);
+    if (executor)
+        return executor(context, task);
+    task.resume();
+}
+
+bool io_resolve_t::await_ready() noexcept {
+    if (host == nullptr || (hint.ai_flags & AI_NUMERICHOST)) {
+        ec = output6.empty() ? get_address(hint, host, serv, output4)
+                             : get_address(hint, host, serv, output6);
+        return true;
+    }
+    return output6.empty() ? lookup_address(hint, host, serv, output4, ec)
+                           : lookup_address(hint, host, serv, output6, ec);
+}
+
+void io_resolve_t::await_suspend(coroutine_handle<void> t) noexcept(false) {
+    task = t;
+    resolver_pool().push(this);
+}
+
+auto resolve_address(const addrinfo& hint, //
+                     gsl::czstring host, gsl::czstring serv,
+                     gsl::span<sockaddr_in> output,
+                     io_resolve_t::executor_type fn, void* ctx) noexcept
+    -> io_resolve_t {
+    return {hint, host, serv, output, fn, ctx};
+}
+
+auto resolve_address(const addrinfo& hint, //
+                     gsl::czstring host, gsl::czstring serv,
+                     gsl::span<sockaddr_in6> output,
+                     io_resolve_t::executor_type fn, void* ctx) noexcept
+    -> io_resolve_t {
+    return {hint, host, serv, output, fn, ctx};
+}
+
 } // namespace coro
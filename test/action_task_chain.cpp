@@ -0,0 +1,87 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+#include <memory>
+
+#include "action.hpp"
+
+using namespace std;
+using namespace coro;
+
+auto return_value(int value) -> task_t<int> {
+    co_return value;
+}
+auto await_and_multiply(int value) -> task_t<int> {
+    auto v = co_await return_value(value);
+    co_return v * 2;
+}
+
+// each `co_await` is a symmetric transfer. the stack won't grow with the depth
+auto sum_recursive(uint32_t n) -> task_t<uint64_t> {
+    if (n == 0)
+        co_return 0;
+    auto sum = co_await sum_recursive(n - 1);
+    co_return sum + n;
+}
+
+auto throw_in_task() noexcept(false) -> task_t<int> {
+    co_await suspend_never{};
+    throw runtime_error{__func__};
+}
+auto catch_from_task(bool& caught) -> task_t<void> {
+    try {
+        co_await throw_in_task();
+    } catch (const runtime_error&) {
+        caught = true;
+    }
+}
+
+auto return_move_only() -> task_t<unique_ptr<int>> {
+    co_return make_unique<int>(7);
+}
+
+int main(int, char*[]) {
+    {
+        auto task = await_and_multiply(3);
+        assert(task.done() == false); // lazily started
+        task.handle().resume();
+        assert(task.done());
+        assert(task.get() == 6);
+    }
+    {
+        constexpr uint32_t depth = 1'000;
+        auto task = sum_recursive(depth);
+        task.handle().resume();
+        assert(task.done());
+        assert(task.get() == uint64_t{depth} * (depth + 1) / 2);
+    }
+    {
+        // the exception is rethrown in the awaiter
+        bool caught = false;
+        auto task = catch_from_task(caught);
+        task.handle().resume();
+        assert(task.done());
+        assert(caught);
+        task.get(); // no exception
+    }
+    {
+        // ... or in `get`
+        auto task = throw_in_task();
+        task.handle().resume();
+        assert(task.done());
+        try {
+            task.get();
+            return __LINE__;
+        } catch (const runtime_error&) {
+        }
+    }
+    {
+        auto task = return_move_only();
+        task.handle().resume();
+        auto ptr = task.get();
+        assert(ptr && *ptr == 7);
+    }
+    return EXIT_SUCCESS;
+}
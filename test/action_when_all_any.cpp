@@ -0,0 +1,143 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "action.hpp"
+
+using namespace std;
+using namespace coro;
+
+/// @brief Suspend and let the caller resume it later
+struct pending_awaitable_t final {
+    mutex& mtx;
+    vector<coroutine_handle<void>>& pending;
+
+  public:
+    constexpr bool await_ready() noexcept {
+        return false;
+    }
+    void await_suspend(coroutine_handle<void> coro) {
+        unique_lock lck{mtx};
+        pending.emplace_back(coro);
+    }
+    constexpr void await_resume() noexcept {
+    }
+};
+
+mutex mtx{};
+vector<coroutine_handle<void>> pending{};
+
+auto wait_and_return(int value) -> task_t<int> {
+    co_await pending_awaitable_t{mtx, pending};
+    co_return value;
+}
+auto return_now(int value) -> task_t<int> {
+    co_return value;
+}
+auto wait_and_count(atomic_uint32_t& count) -> paused_action_t {
+    co_await pending_awaitable_t{mtx, pending};
+    count += 1;
+}
+
+auto await_all(task_t<int>& t1, task_t<int>& t2, paused_action_t& a3, bool& resumed) -> task_t<void> {
+    co_await when_all(t1, t2, a3);
+    resumed = true;
+}
+auto await_all(vector<paused_action_t>& actions) -> task_t<void> {
+    co_await when_all(actions);
+}
+auto await_any(task_t<int>& t1, task_t<int>& t2, task_t<int>& t3) -> task_t<size_t> {
+    co_return co_await when_any(t1, t2, t3);
+}
+
+void resume_pending(size_t index) {
+    auto coro = pending[index];
+    coro.resume();
+}
+
+int main(int, char*[]) {
+    atomic_uint32_t count{};
+    {
+        // the parent is resumed once, by the last one
+        bool resumed = false;
+        auto t1 = wait_and_return(1), t2 = wait_and_return(2);
+        auto a3 = wait_and_count(count);
+        auto parent = await_all(t1, t2, a3, resumed);
+        parent.handle().resume();
+        assert(pending.size() == 3);
+        resume_pending(2);
+        resume_pending(0);
+        assert(resumed == false);
+        assert(parent.done() == false);
+        resume_pending(1);
+        assert(resumed);
+        assert(parent.done());
+        assert(t1.get() + t2.get() == 3);
+        assert(count == 1);
+        pending.clear();
+    }
+    {
+        // all are finished synchronously. the parent doesn't suspend
+        bool resumed = false;
+        auto t1 = return_now(1), t2 = return_now(2);
+        paused_action_t a3 = wait_and_count(count);
+        a3.handle().resume(); // suspended in `pending`
+        resume_pending(0);    // finished before `when_all`
+        auto parent = await_all(t1, t2, a3, resumed);
+        parent.handle().resume();
+        assert(resumed);
+        pending.clear();
+    }
+    {
+        // the first one resumes the parent. the others keep running
+        auto t1 = wait_and_return(1), t2 = wait_and_return(2), t3 = wait_and_return(3);
+        auto parent = await_any(t1, t2, t3);
+        parent.handle().resume();
+        assert(pending.size() == 3);
+        resume_pending(1);
+        assert(parent.done());
+        assert(parent.get() == 1);
+        assert(t2.get() == 2);
+        resume_pending(0);
+        resume_pending(2);
+        assert(t1.done() && t3.done());
+        pending.clear();
+    }
+    {
+        // a finished one is selected without suspension
+        auto t1 = wait_and_return(1), t2 = return_now(2), t3 = wait_and_return(3);
+        t2.handle().resume();
+        auto parent = await_any(t1, t2, t3);
+        parent.handle().resume();
+        assert(parent.done());
+        assert(parent.get() == 1);
+        assert(pending.empty());
+    }
+    {
+        // the children are resumed by the threads at the same time
+        for (auto repeat = 0; repeat < 100; ++repeat) {
+            count = 0;
+            vector<paused_action_t> actions{};
+            for (auto i = 0; i < 8; ++i)
+                actions.emplace_back(wait_and_count(count));
+            auto parent = await_all(actions);
+            parent.handle().resume();
+            assert(pending.size() == actions.size());
+
+            vector<thread> threads{};
+            for (auto coro : pending)
+                threads.emplace_back([coro]() { coro.resume(); });
+            for (auto& t : threads)
+                t.join();
+            assert(count == actions.size());
+            assert(parent.done());
+            pending.clear();
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <array>
+#include <cassert>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+using channel_with_buffer_t = channel<int>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto write_to(channel_with_buffer_t& ch, int value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+auto read_from(channel_with_buffer_t& ch, int& ref, bool& ok) -> no_return_t {
+    tie(ref, ok) = co_await ch.read();
+}
+
+auto write_range_to(channel_with_buffer_t& ch, gsl::span<int> values,
+                    size_t& count) -> no_return_t {
+    count = co_await ch.write_range(values);
+}
+auto read_n_from(channel_with_buffer_t& ch, gsl::span<int> values,
+                 size_t& count) -> no_return_t {
+    count = co_await ch.read_n(values);
+}
+
+int main(int, char*[]) {
+    channel_with_buffer_t ch{3};
+    array<int, 5> source{1, 2, 3, 4, 5};
+    array<int, 5> storage{};
+    size_t wcount = 0, rcount = 0;
+
+    // 3 values fill the buffer. the rest remains
+    write_range_to(ch, source, wcount);
+    assert(wcount == 3);
+
+    // a waiting writer refills the buffer after the batch read
+    bool ok = false;
+    write_to(ch, 4, ok);
+    assert(ok == false);
+    read_n_from(ch, storage, rcount);
+    assert(rcount == 4);
+    assert(ok);
+    for (auto i = 0u; i < rcount; ++i)
+        assert(storage[i] == static_cast<int>(i + 1));
+
+    // the batch reader suspends and takes 1 value from the writer
+    storage = {};
+    read_n_from(ch, storage, rcount = 9);
+    assert(rcount == 9);
+    write_to(ch, 7, ok = false);
+    assert(ok);
+    assert(rcount == 1);
+    assert(storage[0] == 7);
+
+    // waiting readers are served before the buffer
+    int v1 = 0, v2 = 0;
+    bool ok1 = false, ok2 = false;
+    read_from(ch, v1, ok1);
+    read_from(ch, v2, ok2);
+    write_range_to(ch, source, wcount = 0);
+    assert(wcount == 5);
+    assert(ok1 && v1 == 1);
+    assert(ok2 && v2 == 2);
+    read_n_from(ch, storage, rcount = 0);
+    assert(rcount == 3);
+    assert(storage[0] == 3 && storage[2] == 5);
+
+    // closed channel
+    ch.close();
+    write_range_to(ch, source, wcount = 9);
+    assert(wcount == 0);
+    read_n_from(ch, storage, rcount = 9);
+    assert(rcount == 0);
+    return EXIT_SUCCESS;
+}
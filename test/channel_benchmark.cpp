@@ -0,0 +1,187 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ * @brief  Throughput and handoff latency of `channel` for each lockable type
+ *
+ * @code
+ * channel_benchmark [message count per producer]
+ * @endcode
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+using clock_type = chrono::steady_clock;
+
+uint64_t now_ns() noexcept {
+    return chrono::duration_cast<chrono::nanoseconds>(
+               clock_type::now().time_since_epoch())
+        .count();
+}
+
+/// @brief The value in the channel. `timestamp` is for the handoff latency
+template <size_t N>
+struct payload_t final {
+    static_assert(N >= sizeof(uint64_t));
+    uint64_t timestamp;
+    array<byte, N - sizeof(uint64_t)> padding;
+};
+
+struct report_t final {
+    const char* mutex_name;
+    size_t payload;
+    size_t capacity;
+    uint32_t producers, consumers;
+    bool threaded;
+    uint64_t messages;
+    uint64_t elapsed; // nanoseconds
+    vector<uint64_t> latency;
+};
+
+template <typename T, typename M>
+auto produce(channel<T, M>& ch, uint64_t count, atomic_uint64_t& finished)
+    -> no_return_t {
+    T value{};
+    for (auto i = 0u; i < count; ++i) {
+        value.timestamp = now_ns();
+        if (co_await ch.write(value) == false)
+            break;
+    }
+    finished += 1;
+}
+
+template <typename T, typename M>
+auto consume(channel<T, M>& ch, uint64_t count, vector<uint64_t>& latency,
+             atomic_uint64_t& finished) -> no_return_t {
+    for (auto i = 0u; i < count; ++i) {
+        auto [value, ok] = co_await ch.read();
+        if (ok == false)
+            break;
+        latency.emplace_back(now_ns() - value.timestamp);
+    }
+    finished += 1;
+}
+
+/**
+ * @param threaded Run each producer/consumer in its own thread.
+ *                 If `false`, all coroutines are in the current thread
+ */
+template <size_t N, typename M>
+report_t measure(const char* mutex_name, size_t capacity, uint32_t producers,
+                 uint32_t consumers, uint64_t count, bool threaded) {
+    using value_type = payload_t<N>;
+    channel<value_type, M> ch{capacity};
+    atomic_uint64_t finished{};
+
+    const uint64_t total = count * producers;
+    vector<vector<uint64_t>> latency(consumers);
+    for (auto& samples : latency)
+        samples.reserve(total / consumers + 1);
+
+    auto consume_count = [=](uint32_t i) {
+        return total / consumers + (i < total % consumers ? 1 : 0);
+    };
+    const auto start = now_ns();
+    if (threaded) {
+        vector<thread> threads{};
+        for (auto i = 0u; i < consumers; ++i)
+            threads.emplace_back([&, i]() {
+                consume(ch, consume_count(i), latency[i], finished);
+            });
+        for (auto i = 0u; i < producers; ++i)
+            threads.emplace_back([&]() { produce(ch, count, finished); });
+        for (auto& t : threads)
+            t.join();
+    } else {
+        for (auto i = 0u; i < consumers; ++i)
+            consume(ch, consume_count(i), latency[i], finished);
+        for (auto i = 0u; i < producers; ++i)
+            produce(ch, count, finished);
+    }
+    // the last thread which resumed its partner finishes the work
+    while (finished < producers + consumers)
+        this_thread::yield();
+    const auto elapsed = now_ns() - start;
+
+    report_t report{mutex_name, N,        capacity, producers, consumers,
+                    threaded,   total,    elapsed,  {}};
+    for (auto& samples : latency)
+        report.latency.insert(report.latency.end(), samples.begin(),
+                              samples.end());
+    return report;
+}
+
+uint64_t percentile(vector<uint64_t>& samples, double p) {
+    if (samples.empty())
+        return 0;
+    auto it = samples.begin() + static_cast<ptrdiff_t>((samples.size() - 1) * p);
+    nth_element(samples.begin(), it, samples.end());
+    return *it;
+}
+
+void print_header() {
+    printf("%-12s %8s %8s %6s %6s %8s %14s %10s %10s %10s\n", //
+           "mutex", "payload", "capacity", "P", "C", "threaded", "msg/s",
+           "p50(ns)", "p99(ns)", "p999(ns)");
+}
+
+void print(report_t&& r) {
+    const double seconds = static_cast<double>(r.elapsed) / 1e9;
+    printf("%-12s %8zu %8zu %6u %6u %8s %14.0f %10llu %10llu %10llu\n",
+           r.mutex_name, r.payload, r.capacity, r.producers, r.consumers,
+           r.threaded ? "yes" : "no", static_cast<double>(r.messages) / seconds,
+           static_cast<unsigned long long>(percentile(r.latency, 0.50)),
+           static_cast<unsigned long long>(percentile(r.latency, 0.99)),
+           static_cast<unsigned long long>(percentile(r.latency, 0.999)));
+    fflush(stdout);
+}
+
+/// @brief 1:1, N:1, N:M for the payload size. 16+ producers for the contention
+template <size_t N>
+void run_payload(uint64_t count) {
+    for (size_t capacity : {0, 64}) {
+        // `bypass_mutex` can't be used between threads
+        print(measure<N, bypass_mutex>("bypass", capacity, 1, 1, count, false));
+        print(measure<N, bypass_mutex>("bypass", capacity, 4, 4, count, false));
+
+        for (auto [p, c] : {pair{1u, 1u}, pair{2u, 1u}, pair{4u, 1u},
+                            pair{2u, 2u}, pair{4u, 4u}, pair{16u, 1u},
+                            pair{16u, 4u}, pair{32u, 4u}}) {
+            print(measure<N, mutex>("std::mutex", capacity, p, c, count, true));
+            print(measure<N, spin_mutex>("spin_mutex", capacity, p, c, count,
+                                         true));
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t count = 100'000;
+    if (argc > 1)
+        count = strtoull(argv[1], nullptr, 10);
+    if (count == 0)
+        return EXIT_FAILURE;
+
+    print_header();
+    run_payload<8>(count);
+    run_payload<64>(count);
+    run_payload<1024>(count);
+    run_payload<4096>(count);
+    return EXIT_SUCCESS;
+}
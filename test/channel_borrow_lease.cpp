@@ -0,0 +1,99 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <array>
+#include <cassert>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+// not default constructible. counts its construction
+struct payload_t final {
+    static size_t constructed;
+    array<char, 4096> bytes;
+
+    explicit payload_t(char c) noexcept {
+        bytes.fill(c);
+        ++constructed;
+    }
+    payload_t(payload_t&& rhs) noexcept : bytes{rhs.bytes} {
+        ++constructed;
+    }
+    payload_t& operator=(payload_t&&) = default;
+};
+size_t payload_t::constructed = 0;
+
+using channel_payload_t = channel<payload_t>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto write_to(channel_payload_t& ch, char c, bool& ok) -> no_return_t {
+    payload_t value{c};
+    ok = co_await ch.write(value);
+}
+
+// suspend while holding the lease. the writer waits for it
+auto borrow_from(channel_payload_t& ch, char& c) -> frame_t {
+    auto lease = co_await ch.borrow();
+    if (!lease)
+        co_return;
+    c = lease->bytes[4095];
+    co_await suspend_always{};
+}
+
+int main(int, char*[]) {
+    char c = 0;
+    bool ok = false;
+    {
+        // the writer is waiting. borrow references its value
+        channel_payload_t ch{};
+        write_to(ch, 'a', ok);
+        payload_t::constructed = 0;
+        auto h = borrow_from(ch, c);
+        assert(c == 'a');
+        assert(payload_t::constructed == 0); // no copy/move
+        assert(ok == false);                 // the lease is alive
+        h.resume();                          // release the lease
+        assert(ok);
+        h.destroy();
+    }
+    {
+        // the reader is waiting. the writer waits for the release
+        channel_payload_t ch{};
+        auto h = borrow_from(ch, c = 0);
+        payload_t::constructed = 0;
+        write_to(ch, 'b', ok = false);
+        assert(c == 'b');
+        assert(payload_t::constructed == 1); // only the writer's value
+        assert(ok == false);
+        h.resume();
+        assert(ok);
+        h.destroy();
+    }
+    {
+        // buffered value is moved into the lease
+        channel_payload_t ch{1};
+        write_to(ch, 'c', ok = false);
+        assert(ok);
+        auto h = borrow_from(ch, c = 0);
+        assert(c == 'c');
+        h.resume();
+        h.destroy();
+
+        // closed channel gives empty lease
+        ch.close();
+        h = borrow_from(ch, c = 0);
+        assert(c == 0);
+        assert(h.done());
+        h.destroy();
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <cassert>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+using channel_with_buffer_t = channel<int>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto write_to(channel_with_buffer_t& ch, int value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+
+auto read_from(channel_with_buffer_t& ch, int& ref, bool& ok) -> no_return_t {
+    tie(ref, ok) = co_await ch.read();
+}
+
+int main(int, char*[]) {
+    channel_with_buffer_t ch{3};
+    bool ok[4]{};
+
+    // writers won't suspend while the buffer has a space
+    for (auto i = 0; i < 3; ++i) {
+        write_to(ch, i + 1, ok[i]);
+        assert(ok[i]);
+    }
+    // the buffer is full. this one will suspend
+    write_to(ch, 4, ok[3]);
+    assert(ok[3] == false);
+
+    int storage = 0;
+    bool rok = false;
+    // reader takes the front. the suspended writer fills the buffer
+    read_from(ch, storage, rok);
+    assert(rok);
+    assert(storage == 1);
+    assert(ok[3]);
+
+    // remaining values are in FIFO order
+    for (auto i : {2, 3, 4}) {
+        read_from(ch, storage, rok = false);
+        assert(rok);
+        assert(storage == i);
+    }
+
+    // the buffer is empty. the reader will suspend
+    storage = 0;
+    read_from(ch, storage, rok = false);
+    assert(rok == false);
+    bool wok = false;
+    write_to(ch, 5, wok); // the writer pairs with the reader directly
+    assert(wok);
+    assert(rok);
+    assert(storage == 5);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <cassert>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+using channel_with_buffer_t = channel<int>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto write_to(channel_with_buffer_t& ch, int value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+
+auto read_from(channel_with_buffer_t& ch, int& ref, bool& ok) -> no_return_t {
+    tie(ref, ok) = co_await ch.read();
+}
+
+int main(int, char*[]) {
+    channel_with_buffer_t ch{1};
+    bool ok[2]{};
+
+    // one in the buffer, one waiting
+    write_to(ch, 1, ok[0]);
+    write_to(ch, 2, ok[1]);
+    assert(ok[0]);
+    assert(ok[1] == false);
+
+    // the waiting writer fails. the buffered value remains
+    assert(ch.is_closed() == false);
+    ch.close();
+    assert(ch.is_closed());
+    assert(ok[1] == false);
+
+    // writes fail without suspension
+    bool wok = true;
+    write_to(ch, 3, wok);
+    assert(wok == false);
+
+    // readers drain the buffer first
+    int storage = 0;
+    bool rok = false;
+    read_from(ch, storage, rok);
+    assert(rok);
+    assert(storage == 1);
+
+    // then fail without suspension
+    read_from(ch, storage = 0, rok = true);
+    assert(rok == false);
+    assert(storage == 0);
+
+    // waiting readers are resumed by the close
+    channel_with_buffer_t ch2{};
+    read_from(ch2, storage, rok = true);
+    ch2.close();
+    assert(rok == false);
+    ch2.close(); // multiple close is safe
+    return EXIT_SUCCESS;
+}
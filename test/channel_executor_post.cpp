@@ -0,0 +1,78 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <cassert>
+#include <queue>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+using channel_without_lock_t = channel<int>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+using task_queue_t = queue<coroutine_handle<void>>;
+
+void post_to_queue(void* ctx, coroutine_handle<void> coro) {
+    auto* tasks = reinterpret_cast<task_queue_t*>(ctx);
+    tasks->push(coro);
+}
+
+size_t drain(task_queue_t& tasks) {
+    size_t count = 0;
+    for (; tasks.empty() == false; ++count) {
+        auto coro = tasks.front();
+        tasks.pop();
+        coro.resume();
+    }
+    return count;
+}
+
+auto write_to(channel_without_lock_t& ch, int value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+auto read_from(channel_without_lock_t& ch, int& ref, bool& ok) -> no_return_t {
+    tie(ref, ok) = co_await ch.read();
+}
+
+int main(int, char*[]) {
+    task_queue_t tasks{};
+    channel_without_lock_t ch{};
+    ch.set_executor(post_to_queue, &tasks);
+
+    int value = 0;
+    bool rok = false, wok = false;
+
+    // the reader waits. the writer posts it and waits for the move
+    read_from(ch, value, rok);
+    write_to(ch, 3, wok);
+    assert(rok == false && wok == false);
+    assert(drain(tasks) == 2); // reader, then the writer
+    assert(rok && wok);
+    assert(value == 3);
+
+    // the writer waits. the reader moves the value and posts the writer
+    write_to(ch, 4, wok = false);
+    read_from(ch, value, rok = false);
+    assert(rok);
+    assert(value == 4);
+    assert(wok == false);
+    assert(drain(tasks) == 1);
+    assert(wok);
+
+    // close posts the waiting coroutines
+    read_from(ch, value, rok = true);
+    ch.close();
+    assert(rok);
+    assert(drain(tasks) == 1);
+    assert(rok == false);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+using channel_spin_t = channel<uint64_t, spin_mutex>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+static constexpr uint64_t thread_count = 8;
+static constexpr uint64_t message_count = 2'000;
+
+atomic_uint64_t total{}, failure{}, finished{};
+
+auto send_all(channel_spin_t& ch, uint64_t value) -> no_return_t {
+    for (auto i = 0u; i < message_count; ++i)
+        if (co_await ch.write(value) == false)
+            failure += 1;
+    finished += 1;
+}
+
+auto recv_all(channel_spin_t& ch) -> no_return_t {
+    for (auto i = 0u; i < message_count; ++i) {
+        auto [value, ok] = co_await ch.read();
+        ok ? total += value : failure += 1;
+    }
+    finished += 1;
+}
+
+int main(int, char*[]) {
+    channel_spin_t ch{};
+    {
+        vector<thread> threads{};
+        // coroutines migrate between the threads.
+        // the last one which resumes its partner finishes the work
+        for (auto i = 1u; i <= thread_count; ++i) {
+            threads.emplace_back([&ch, i]() { send_all(ch, i); });
+            threads.emplace_back([&ch]() { recv_all(ch); });
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+    assert(failure == 0);
+    assert(finished == 2 * thread_count);
+    // sum of [1, thread_count] for each message
+    assert(total == message_count * thread_count * (thread_count + 1) / 2);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+
+#undef NDEBUG
+#include <cassert>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+using u32_chan_t = channel<uint32_t>;
+using i32_chan_t = channel<int32_t>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto write_to(i32_chan_t& ch, int32_t value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+auto write_to(u32_chan_t& ch, uint32_t value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+
+auto select_from(u32_chan_t& ch1, i32_chan_t& ch2, //
+                 size_t& index, uint32_t& v1, int32_t& v2) -> no_return_t {
+    bool ok = false;
+    tie(index, ok) = co_await select_async(
+        ch1, [&v1](uint32_t v) { v1 = v; }, //
+        ch2, [&v2](int32_t v) { v2 = v; });
+    assert(ok);
+}
+
+int main(int, char*[]) {
+    u32_chan_t ch1{};
+    i32_chan_t ch2{};
+    size_t index = 0;
+    uint32_t v1 = 0;
+    int32_t v2 = 0;
+    bool ok = false;
+
+    // there is a waiting writer. select won't suspend
+    write_to(ch2, -3, ok);
+    assert(ok == false);
+    select_from(ch1, ch2, index, v1, v2);
+    assert(ok);
+    assert(index == 1);
+    assert(v2 == -3);
+
+    // no writer. the coroutine suspends in both channels
+    index = 0, v2 = 0;
+    select_from(ch1, ch2, index, v1, v2);
+    write_to(ch2, 7, ok = false);
+    assert(ok);
+    assert(index == 1);
+    assert(v2 == 7);
+    assert(v1 == 0);
+
+    // the reader in ch1 is cancelled. the writer must wait
+    write_to(ch1, 11u, ok = false);
+    assert(ok == false);
+    select_from(ch1, ch2, index, v1, v2);
+    assert(ok);
+    assert(index == 0);
+    assert(v1 == 11u);
+
+    // value in the buffer is also available
+    u32_chan_t ch3{2};
+    write_to(ch3, 5u, ok = false);
+    assert(ok);
+    select_from(ch3, ch2, index, v1, v2);
+    assert(index == 0);
+    assert(v1 == 5u);
+    return EXIT_SUCCESS;
+}
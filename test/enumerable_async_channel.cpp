@@ -0,0 +1,87 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+#include <stdexcept>
+
+#include <coroutine/channel.hpp>
+#include <coroutine/return.h>
+#include <coroutine/yield.hpp>
+
+using namespace std;
+using namespace coro;
+
+using channel_t = channel<int>;
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto write_to(channel_t& ch, int value, bool& ok) -> no_return_t {
+    ok = co_await ch.write(value);
+}
+
+// the producer awaits the channel between the yields
+auto double_all(channel_t& ch) -> async_enumerable<int> {
+    while (true) {
+        auto [value, ok] = co_await ch.read();
+        if (ok == false || value < 0)
+            co_return;
+        co_yield value * 2;
+    }
+}
+
+auto sum_all(channel_t& ch, int& total, int& count) -> no_return_t {
+    auto values = double_all(ch);
+    while (int* value = co_await values.next()) {
+        total += *value;
+        count += 1;
+    }
+    count = -count; // finished
+}
+
+auto throw_after(int n) -> async_enumerable<int> {
+    for (auto i = 0; i < n; ++i)
+        co_yield i;
+    throw runtime_error{"producer"};
+}
+
+auto catch_all(int& count, bool& caught) -> no_return_t {
+    auto values = throw_after(2);
+    try {
+        while (co_await values.next())
+            count += 1;
+    } catch (const runtime_error&) {
+        caught = true;
+    }
+}
+
+int main(int, char*[]) {
+    channel_t ch{};
+    int total = 0, count = 0;
+    bool ok = false;
+
+    // the consumer waits in `next`. the producer waits in the channel
+    sum_all(ch, total, count);
+    assert(count == 0);
+    for (auto v : {1, 2, 3}) {
+        write_to(ch, v, ok = false);
+        assert(ok); // the producer was waiting
+        assert(count == v);
+    }
+    assert(total == 12);
+    // the producer returns. the consumer sees the end
+    write_to(ch, -1, ok = false);
+    assert(ok);
+    assert(count == -3);
+
+    // the exception is delivered to the consumer
+    bool caught = false;
+    count = 0;
+    catch_all(count, caught);
+    assert(caught);
+    assert(count == 2);
+    return EXIT_SUCCESS;
+}
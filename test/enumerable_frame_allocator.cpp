@@ -0,0 +1,123 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+#include <cstdlib>
+#include <thread>
+
+#include <coroutine/yield.hpp>
+
+using namespace std;
+using namespace coro;
+
+size_t global_count = 0; // `operator new` from the program
+
+void* operator new(size_t size) {
+    ++global_count;
+    if (auto ptr = malloc(size))
+        return ptr;
+    throw bad_alloc{};
+}
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+/// @brief Allocator which counts its usage
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+    size_t* count;
+
+    explicit counting_allocator(size_t* _count) noexcept : count{_count} {
+    }
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& rhs) noexcept
+        : count{rhs.count} {
+    }
+    T* allocate(size_t n) {
+        *count += 1;
+        return static_cast<T*>(malloc(n * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t) noexcept {
+        *count -= 1;
+        free(ptr);
+    }
+};
+
+auto yield_range(int n) -> enumerable<int> {
+    for (auto i = 0; i < n; ++i)
+        co_yield i;
+}
+
+auto yield_range(allocator_arg_t, counting_allocator<int>, int n)
+    -> enumerable<int> {
+    for (auto i = 0; i < n; ++i)
+        co_yield i;
+}
+
+struct source_t {
+    int n;
+    auto range(allocator_arg_t, counting_allocator<int>) const
+        -> enumerable<int> {
+        for (auto i = 0; i < n; ++i)
+            co_yield i;
+    }
+};
+
+int sum(enumerable<int>&& g) {
+    int total = 0;
+    for (auto v : g)
+        total += v;
+    return total;
+}
+
+/// @brief Constructed before the `frame_recycler`, so it is destroyed after the recycler
+struct holder_t {
+    enumerable<int> g{};
+};
+
+void hold_until_exit() {
+    static thread_local holder_t holder{};
+    holder.g = yield_range(3);
+    auto it = holder.g.begin();
+    assert(*it == 0);
+}
+
+int main(int, char*[]) {
+    // the frame is returned to the recycler of the current thread
+    assert(sum(yield_range(5)) == 10);
+    const auto before = global_count;
+    for (auto i = 0; i < 100; ++i) {
+        // the nested ones are also recycled
+        auto outer = yield_range(3);
+        assert(sum(yield_range(4)) == 6);
+        assert(sum(move(outer)) == 3);
+    }
+    assert(global_count - before <= 1); // the 2nd size for the nested one
+
+    // with the allocator in the arguments. the frame is released with it
+    size_t live = 0;
+    {
+        auto g = yield_range(allocator_arg, counting_allocator<int>{&live}, 5);
+        assert(live == 1);
+        assert(sum(move(g)) == 10);
+    }
+    assert(live == 0);
+
+    // the member function
+    {
+        source_t source{4};
+        auto g = source.range(allocator_arg, counting_allocator<int>{&live});
+        assert(live == 1);
+        assert(sum(move(g)) == 6);
+    }
+    assert(live == 0);
+
+    // the frame which is destroyed after the recycler in the thread's exit
+    thread{hold_until_exit}.join();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ * @brief  The arguments with `std::allocator_arg_t` which `promise_alloc` can't use
+ *         must not fall back to the `frame_recycler`
+ *
+ * @code
+ * // must fail to compile
+ * g++ -std=c++20 -fcoroutines -DEXPECT_COMPILE_ERROR enumerable_frame_allocator_args.cpp
+ * @endcode
+ */
+#undef NDEBUG
+#include <cassert>
+#include <cstdlib>
+#include <memory>
+
+#include <coroutine/yield.hpp>
+
+using namespace std;
+using namespace coro;
+
+/// @brief Allocator which counts its usage
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+    size_t* count;
+
+    explicit counting_allocator(size_t* _count) noexcept : count{_count} {
+    }
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& rhs) noexcept
+        : count{rhs.count} {
+    }
+    T* allocate(size_t n) {
+        *count += 1;
+        return static_cast<T*>(malloc(n * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t) noexcept {
+        *count -= 1;
+        free(ptr);
+    }
+};
+
+using promise_type = enumerable<int>::promise_type;
+using alloc_t = counting_allocator<int>;
+
+/**
+ * @brief Overload resolution finds an `operator new` for the arguments.
+ *        If not, the frame falls back to `operator new(size_t)`
+ * @note  The unsupported ones are found too, and fail with `static_assert` when they are used
+ */
+template <typename... Args>
+constexpr bool has_operator_new = requires(Args&&... args) {
+    promise_type::operator new(sizeof(void*), std::forward<Args>(args)...);
+};
+
+// the recycler
+static_assert(has_operator_new<>);
+// up to 4 arguments after the allocator
+static_assert(has_operator_new<allocator_arg_t, alloc_t, int, int, int, int>);
+static_assert(has_operator_new<allocator_arg_t, alloc_t, int, int, int, int, int>);
+static_assert(has_operator_new<allocator_arg_t>);
+// the member function. the object is before the `allocator_arg`
+struct source_t;
+static_assert(has_operator_new<source_t&, allocator_arg_t, alloc_t, int, int, int, int>);
+static_assert(has_operator_new<source_t&, allocator_arg_t, alloc_t, int, int, int, int, int>);
+static_assert(has_operator_new<source_t&, allocator_arg_t>);
+// the `allocator_arg` in the other position
+static_assert(has_operator_new<source_t&, int, allocator_arg_t, alloc_t>);
+
+auto yield_sum(allocator_arg_t, alloc_t, int a, int b, int c, int d)
+    -> enumerable<int> {
+    co_yield a + b + c + d;
+}
+
+struct source_t {
+    int n;
+    auto yield_sum(allocator_arg_t, alloc_t, int a, int b, int c, int d) const
+        -> enumerable<int> {
+        co_yield n + a + b + c + d;
+    }
+#if defined(EXPECT_COMPILE_ERROR)
+    auto yield_sum(allocator_arg_t, alloc_t, int a, int b, int c, int d, int e) const
+        -> enumerable<int> {
+        co_yield n + a + b + c + d + e;
+    }
+#endif
+};
+
+#if defined(EXPECT_COMPILE_ERROR)
+auto yield_sum(allocator_arg_t, alloc_t, int a, int b, int c, int d, int e)
+    -> enumerable<int> {
+    co_yield a + b + c + d + e;
+}
+#endif
+
+int main(int, char*[]) {
+    size_t live = 0;
+    {
+        auto g = yield_sum(allocator_arg, alloc_t{&live}, 1, 2, 3, 4);
+        assert(live == 1);
+        for (auto v : g)
+            assert(v == 10);
+    }
+    assert(live == 0);
+    {
+        source_t source{5};
+        auto g = source.yield_sum(allocator_arg, alloc_t{&live}, 1, 2, 3, 4);
+        assert(live == 1);
+        for (auto v : g)
+            assert(v == 15);
+    }
+    assert(live == 0);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+#include <string>
+#include <vector>
+#if __has_include(<ranges>)
+#include <ranges>
+#endif
+
+#include <coroutine/yield.hpp>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__cpp_lib_ranges)
+static_assert(ranges::input_range<enumerable<int>>);
+static_assert(ranges::input_range<take_view<enumerable<int>&, size_t>>);
+#endif
+
+// count the resumes to check the pipeline doesn't consume more
+auto sequence(int& resumed) -> enumerable<int> {
+    for (auto i = 1;; ++i) {
+        resumed += 1;
+        co_yield i;
+    }
+}
+
+auto yield_names() -> enumerable<string> {
+    co_yield "a";
+    co_yield "bb";
+    co_yield "ccc";
+}
+
+int main(int, char*[]) {
+    int resumed = 0;
+    {
+        vector<int> values{};
+        for (int v : sequence(resumed) // the view owns the generator
+                         | filter([](int v) { return v % 2 == 0; })
+                         | transform([](int v) { return v * 10; }) //
+                         | take(3))
+            values.emplace_back(v);
+        assert((values == vector<int>{20, 40, 60}));
+        // the generator is not resumed after the 3rd element
+        assert(resumed == 6);
+    }
+    resumed = 0;
+    {
+        auto g = sequence(resumed);
+        vector<vector<int>> chunks{};
+        for (const auto& c : g | take(7) | chunk(3))
+            chunks.emplace_back(c);
+        assert(chunks.size() == 3);
+        assert((chunks[0] == vector<int>{1, 2, 3}));
+        assert((chunks[2] == vector<int>{7}));
+        assert(resumed == 7);
+    }
+    resumed = 0;
+    {
+        size_t count = 0;
+        for (auto [i, name] : zip(sequence(resumed), yield_names())) {
+            assert(name.size() == static_cast<size_t>(i));
+            count += 1;
+        }
+        assert(count == 3);
+    }
+#if defined(__cpp_lib_ranges)
+    {
+        // enumerable can be used with the standard views
+        auto g = yield_names();
+        size_t total = 0;
+        for (auto len : g | views::transform([](auto& s) { return s.size(); }))
+            total += len;
+        assert(total == 6);
+    }
+#endif
+    return EXIT_SUCCESS;
+}
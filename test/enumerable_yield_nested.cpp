@@ -0,0 +1,100 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+#include <coroutine/yield.hpp>
+
+using namespace std;
+using namespace coro;
+
+struct node_t final {
+    int value;
+    vector<node_t> children;
+};
+
+auto walk(node_t& node, size_t& depth, size_t& max_depth) -> enumerable<int> {
+    depth += 1;
+    if (max_depth < depth)
+        max_depth = depth;
+    co_yield node.value;
+    for (auto& child : node.children)
+        co_yield elements_of(walk(child, depth, max_depth));
+    depth -= 1;
+}
+
+auto yield_range(int first, int last) -> enumerable<int> {
+    for (auto i = first; i < last; ++i)
+        co_yield i;
+}
+auto yield_twice() -> enumerable<int> {
+    co_yield elements_of(yield_range(0, 0)); // empty
+    co_yield elements_of(yield_range(0, 2));
+    auto g = yield_range(2, 4);
+    co_yield elements_of(std::move(g));
+}
+
+auto yield_then_throw() -> enumerable<int> {
+    co_yield 1;
+    throw runtime_error{"nested"};
+}
+auto catch_nested(bool& caught) -> enumerable<int> {
+    try {
+        co_yield elements_of(yield_then_throw());
+    } catch (const runtime_error&) {
+        caught = true;
+    }
+    co_yield 2;
+}
+
+// the tree is a list. the depth is same with the count
+node_t make_chain(int depth) {
+    node_t root{0, {}};
+    node_t* node = &root;
+    for (auto i = 1; i < depth; ++i) {
+        node->children.emplace_back(node_t{i, {}});
+        node = &node->children.back();
+    }
+    return root;
+}
+
+int main(int, char*[]) {
+    {
+        node_t tree{1, {{2, {{3, {}}, {4, {}}}}, {5, {}}}};
+        size_t depth = 0, max_depth = 0;
+        vector<int> values{};
+        for (auto v : walk(tree, depth, max_depth))
+            values.emplace_back(v);
+        assert((values == vector<int>{1, 2, 3, 4, 5}));
+        assert(depth == 0);
+        assert(max_depth == 3);
+    }
+    {
+        auto tree = make_chain(200);
+        size_t depth = 0, max_depth = 0;
+        int expected = 0;
+        for (auto v : walk(tree, depth, max_depth))
+            assert(v == expected++);
+        assert(expected == 200);
+        assert(max_depth == 200);
+    }
+    {
+        vector<int> values{};
+        for (auto v : yield_twice())
+            values.emplace_back(v);
+        assert((values == vector<int>{0, 1, 2, 3}));
+    }
+    {
+        // the parent can catch the exception of the nested one
+        bool caught = false;
+        vector<int> values{};
+        for (auto v : catch_nested(caught))
+            values.emplace_back(v);
+        assert(caught);
+        assert((values == vector<int>{1, 2}));
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <coroutine/linux.h>
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+int64_t open_udp(sockaddr_in& local) {
+    const auto sd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    if (sd < 0)
+        return sd;
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = 0; // let system define the port
+    socklen_t len = sizeof(local);
+    if (bind(sd, reinterpret_cast<sockaddr*>(&local), len) ||
+        getsockname(sd, reinterpret_cast<sockaddr*>(&local), &len)) {
+        close(sd);
+        return -1;
+    }
+    return sd;
+}
+
+auto recv_in_worker(io_context& ctx, int64_t sd, int64_t& rsz,
+                    thread::id& tid, atomic_uint32_t& wg) -> no_return_t {
+    co_await ctx.schedule(); // the epoll of the worker will be used
+    tid = this_thread::get_id();
+
+    sockaddr_in remote{};
+    io_work_t work{};
+    array<byte, 1000> storage{};
+    rsz = co_await recv_from(sd, remote, storage, work);
+    if (work.error())
+        rsz = -1;
+    wg += 1;
+}
+
+auto send_in_worker(io_context& ctx, int64_t sd, const sockaddr_in& remote,
+                    int64_t& ssz, atomic_uint32_t& wg) -> no_return_t {
+    co_await ctx.schedule();
+
+    io_work_t work{};
+    array<byte, 700> storage{};
+    ssz = co_await send_to(sd, remote, storage, work);
+    if (work.error())
+        ssz = -1;
+    wg += 1;
+}
+
+auto throw_in_worker(io_context& ctx) -> frame_t {
+    co_await ctx.schedule();
+    throw runtime_error{"worker"};
+}
+
+int main(int, char*[]) {
+    sockaddr_in addr1{}, addr2{};
+    const auto sd1 = open_udp(addr1);
+    const auto sd2 = open_udp(addr2);
+    if (sd1 < 0 || sd2 < 0)
+        return __LINE__;
+    auto on_return = gsl::finally([sd1, sd2]() {
+        close(sd1);
+        close(sd2);
+    });
+
+    io_context ctx{2};
+    if (ctx.concurrency() != 2)
+        return __LINE__;
+    thread runner{[&ctx]() { ctx.run(); }};
+
+    atomic_uint32_t wg{};
+    int64_t rsz = 0, ssz = 0;
+    thread::id tid{};
+    recv_in_worker(ctx, sd1, rsz, tid, wg);
+    send_in_worker(ctx, sd2, addr1, ssz, wg);
+
+    // wait for the workers
+    for (auto i = 0; i < 200 && wg < 2; ++i)
+        this_thread::sleep_for(10ms);
+    ctx.stop();
+    runner.join();
+
+    if (wg != 2)
+        return __LINE__;
+    if (tid == this_thread::get_id()) // resumed in the worker
+        return __LINE__;
+    if (ssz != 700 || rsz != ssz)
+        return __LINE__;
+
+    // `run` again. the posts are distributed to the both workers in turn.
+    // the exception stops all workers and `run` rethrows it
+    for (auto i = 0; i < 2; ++i) {
+        bool thrown = false;
+        thread runner{[&ctx, &thrown]() {
+            try {
+                ctx.run();
+            } catch (const runtime_error&) {
+                thrown = true;
+            }
+        }};
+        auto frame = throw_in_worker(ctx);
+        runner.join();
+        frame.destroy();
+        if (thrown == false)
+            return __LINE__;
+    }
+    return EXIT_SUCCESS;
+}
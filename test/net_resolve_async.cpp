@@ -0,0 +1,119 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ * @brief `getaddrinfo` in the resolver threads
+ */
+#undef NDEBUG
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+// see 'external/sockets'
+void socket_setup() noexcept(false);
+void socket_teardown() noexcept;
+
+/// @brief Resume the posted coroutines in the main thread
+struct queue_executor_t final {
+    mutex mtx{};
+    vector<coroutine_handle<void>> tasks{};
+
+    static void execute(void* ctx, coroutine_handle<void> coro) {
+        auto self = reinterpret_cast<queue_executor_t*>(ctx);
+        unique_lock lck{self->mtx};
+        self->tasks.emplace_back(coro);
+    }
+    size_t drain() {
+        vector<coroutine_handle<void>> ready{};
+        {
+            unique_lock lck{mtx};
+            ready.swap(tasks);
+        }
+        for (auto coro : ready)
+            coro.resume();
+        return ready.size();
+    }
+};
+
+auto resolve(const addrinfo& hint, gsl::czstring host,
+             gsl::span<sockaddr_in6> output, atomic<uint32_t>& ec,
+             atomic<bool>& done, thread::id& resumed,
+             queue_executor_t* executor = nullptr) -> no_return_t {
+    if (executor)
+        ec = co_await resolve_address(hint, host, "7", output,
+                                      queue_executor_t::execute, executor);
+    else
+        ec = co_await resolve_address(hint, host, "7", output);
+    resumed = this_thread::get_id();
+    done = true;
+}
+
+int main(int, char*[]) {
+    socket_setup();
+    auto on_return = gsl::finally([]() { socket_teardown(); });
+
+    addrinfo hint{};
+    hint.ai_family = AF_INET6;
+    hint.ai_socktype = SOCK_STREAM;
+    hint.ai_flags = AI_V4MAPPED | AI_ALL;
+
+    atomic<uint32_t> ec{};
+    atomic<bool> done{};
+    thread::id resumed{};
+
+    // the numeric host doesn't suspend
+    array<sockaddr_in6, 1> numeric{};
+    hint.ai_flags |= AI_NUMERICHOST;
+    resolve(hint, "::1", numeric, ec, done, resumed);
+    assert(done);
+    assert(ec == 0);
+    assert(resumed == this_thread::get_id());
+    assert(numeric[0].sin6_port == htons(7));
+    hint.ai_flags &= ~AI_NUMERICHOST;
+
+    // resumed in the resolver thread
+    array<sockaddr_in6, 4> names{};
+    done = false;
+    resolve(hint, "localhost", names, ec, done, resumed);
+    while (done == false)
+        this_thread::yield();
+    assert(ec == 0);
+    assert(resumed != this_thread::get_id());
+    assert(names[0].sin6_family == AF_INET6);
+    assert(names[0].sin6_port == htons(7));
+
+    // the result is in the cache. no suspension
+    done = false;
+    resolve(hint, "localhost", names, ec, done, resumed);
+    assert(done);
+    assert(resumed == this_thread::get_id());
+    assert(names[0].sin6_port == htons(7));
+
+    // resumed by the executor
+    clear_resolver_cache();
+    queue_executor_t executor{};
+    array<sockaddr_in6, 4> posted{};
+    done = false;
+    resolve(hint, "localhost", posted, ec, done, resumed,
+            addressof(executor));
+    while (executor.drain() == 0)
+        this_thread::yield();
+    assert(done);
+    assert(ec == 0);
+    assert(resumed == this_thread::get_id());
+    assert(posted[0].sin6_port == htons(7));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ * @brief positive/negative entries of the resolver cache
+ */
+#undef NDEBUG
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <coroutine/net.h>
+
+using namespace std;
+using namespace coro;
+
+// see 'external/sockets'
+void socket_setup() noexcept(false);
+void socket_teardown() noexcept;
+
+int main(int, char*[]) {
+    socket_setup();
+    auto on_return = gsl::finally([]() { socket_teardown(); });
+
+    addrinfo hint{};
+    hint.ai_family = AF_INET6;
+    hint.ai_socktype = SOCK_STREAM;
+    hint.ai_flags = AI_V4MAPPED | AI_ALL;
+
+    // the first one is a miss. the next one is from the cache
+    array<sockaddr_in6, 2> first{}, second{};
+    auto before = get_resolver_cache_stats();
+    assert(get_address_cached(hint, "localhost", "7", first) == 0);
+    assert(get_address_cached(hint, "localhost", "7", second) == 0);
+    auto after = get_resolver_cache_stats();
+    assert(after.miss == before.miss + 1);
+    assert(after.hit == before.hit + 1);
+    assert(second[0].sin6_family == AF_INET6);
+    assert(second[0].sin6_port == htons(7));
+    assert(memcmp(first.data(), second.data(), sizeof(first)) == 0);
+
+    // the key includes the hint
+    hint.ai_socktype = SOCK_DGRAM;
+    before = get_resolver_cache_stats();
+    assert(get_address_cached(hint, "localhost", "7", second) == 0);
+    assert(get_resolver_cache_stats().miss == before.miss + 1);
+    hint.ai_socktype = SOCK_STREAM;
+
+    // the failure is also cached
+    const auto ec = get_address_cached(hint, "localhost", "no-such-service", first);
+    assert(ec != 0);
+    before = get_resolver_cache_stats();
+    assert(get_address_cached(hint, "localhost", "no-such-service", first) == ec);
+    assert(get_resolver_cache_stats().hit == before.hit + 1);
+
+    // the entries are removed
+    clear_resolver_cache();
+    before = get_resolver_cache_stats();
+    assert(get_address_cached(hint, "localhost", "7", second) == 0);
+    assert(get_resolver_cache_stats().miss == before.miss + 1);
+
+    // more keys than the cache. the live entries are evicted
+    hint.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+    before = get_resolver_cache_stats();
+    for (auto port = 1; port <= 1000; ++port)
+        assert(get_address_cached(hint, "::1", to_string(port).c_str(), first) == 0);
+    assert(get_resolver_cache_stats().eviction > before.eviction);
+
+    // readers don't block each other. the writer may replace the entries
+    {
+        vector<thread> threads{};
+        for (auto i = 0; i < 4; ++i)
+            threads.emplace_back([&hint, i]() {
+                array<sockaddr_in6, 1> output{};
+                for (auto port = 1; port <= 2000; ++port) {
+                    const auto serv = to_string(port * (i + 1) % 500 + 1);
+                    assert(get_address_cached(hint, "::1", serv.c_str(), output) == 0);
+                    assert(output[0].sin6_port == htons(stoi(serv)));
+                }
+            });
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // `0` disables the cache
+    set_resolver_cache_ttl(0s, 0s);
+    hint.ai_flags = AI_V4MAPPED | AI_ALL;
+    before = get_resolver_cache_stats();
+    assert(get_address_cached(hint, "localhost", "7", second) == 0);
+    assert(get_address_cached(hint, "localhost", "7", second) == 0);
+    after = get_resolver_cache_stats();
+    assert(after.hit == before.hit);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+
+#include <coroutine/linux.h>
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto recv_once(int64_t sd, io_work_t& work, int64_t& rsz) -> no_return_t {
+    array<byte, 64> buf{};
+    rsz = co_await recv_stream(sd, buf, 0, work);
+}
+
+bool send_some(int64_t sd) {
+    array<byte, 10> buf{};
+    return write(sd, buf.data(), buf.size()) == 10;
+}
+
+/// @note With io_uring, the blocking socket is also polled
+bool complete(int64_t& rsz) {
+    for (auto repeat = 100; repeat && rsz == 0; --repeat)
+        poll_net_tasks(10'000'000);
+    return rsz == 10;
+}
+
+/// @brief The reader must be resumed with the data
+bool wait_for(int64_t sd, int64_t& rsz) {
+    if (rsz != 0) // suspended?
+        return false;
+    if (send_some(sd) == false)
+        return false;
+    return complete(rsz);
+}
+
+int main(int, char*[]) {
+    int sds[2]{};
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sds) != 0)
+        return __LINE__;
+    auto on_return = gsl::finally([&sds]() {
+        close(sds[0]);
+        close(sds[1]);
+    });
+
+    io_work_t work{};
+    int64_t rsz = 0;
+    // the work caches the blocking mode
+    if (send_some(sds[1]) == false)
+        return __LINE__;
+    recv_once(sds[0], work, rsz);
+    if (complete(rsz) == false)
+        return __LINE__;
+
+    // the registration made the socket non-blocking. the work must suspend
+    {
+        io_registration reg{sds[0]};
+        recv_once(sds[0], work, rsz = 0);
+        if (wait_for(sds[1], rsz) == false)
+            return __LINE__;
+    }
+
+    // same descriptor, but non-blocking without the registration.
+    // `EAGAIN` from the blocking path refreshes the mode and suspends
+    int other[2]{};
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, other) != 0)
+        return __LINE__;
+    auto on_return2 = gsl::finally([&other]() {
+        close(other[0]);
+        close(other[1]);
+    });
+    if (send_some(other[1]) == false)
+        return __LINE__;
+    recv_once(other[0], work, rsz = 0); // blocking. cache the mode again
+    if (complete(rsz) == false)
+        return __LINE__;
+    if (fcntl(other[0], F_SETFL, fcntl(other[0], F_GETFL, 0) | O_NONBLOCK) != 0)
+        return __LINE__;
+    recv_once(other[0], work, rsz = 0);
+    if (wait_for(other[1], rsz) == false)
+        return __LINE__;
+    return EXIT_SUCCESS;
+}
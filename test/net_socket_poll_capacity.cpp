@@ -0,0 +1,90 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto recv_once(int64_t sd, io_buffer_t buf, int64_t& rsz) -> no_return_t {
+    io_work_t work{};
+    rsz = co_await recv_stream(sd, buf, 0, work);
+}
+
+int main(int, char*[]) {
+    constexpr auto count = 8;
+    array<array<int, 2>, count> pairs{};
+    array<int64_t, count> sizes{};
+    array<array<byte, 16>, count> bufs{};
+    for (auto& sds : pairs)
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sds.data()) != 0)
+            return __LINE__;
+    auto on_return = gsl::finally([&pairs]() {
+        for (auto& sds : pairs) {
+            close(sds[0]);
+            close(sds[1]);
+        }
+    });
+
+    // all receivers are suspended
+    for (auto i = 0; i < count; ++i)
+        recv_once(pairs[i][0], bufs[i], sizes[i]);
+    for (auto& sds : pairs)
+        if (send(sds[1], "ping", 4, 0) != 4)
+            return __LINE__;
+
+    // 2 events for each poll
+    set_net_poll_capacity(2);
+    ptrdiff_t total = 0;
+    for (auto repeat = 100; repeat && total < count / 2; --repeat) {
+        const auto resumed = poll_net_tasks(10'000'000);
+        if (resumed > 2)
+            return __LINE__;
+        total += resumed;
+    }
+    if (total != count / 2)
+        return __LINE__;
+
+    // the others in 1 poll
+    set_net_poll_capacity(64);
+    if (poll_net_tasks(10'000'000) != count / 2)
+        return __LINE__;
+    for (auto sz : sizes)
+        if (sz != 4)
+            return __LINE__;
+
+    // 2 threads poll while the capacity is changed. each one is resumed once
+    for (auto i = 0; i < count; ++i)
+        recv_once(pairs[i][0], bufs[i], sizes[i] = 0);
+    atomic<ptrdiff_t> resumed{0};
+    auto poll_until_done = [&resumed]() {
+        for (auto repeat = 1000; repeat && resumed.load() < count; --repeat)
+            resumed += poll_net_tasks(1'000'000);
+    };
+    thread t1{poll_until_done}, t2{poll_until_done};
+    auto sent = 0;
+    for (auto i = 0; i < count; ++i) {
+        set_net_poll_capacity(i % 2 ? 1 : 64);
+        sent += send(pairs[i][1], "pong", 4, 0) == 4;
+    }
+    t1.join();
+    t2.join();
+    if (sent != count || resumed != count)
+        return __LINE__;
+    for (auto sz : sizes)
+        if (sz != 4)
+            return __LINE__;
+    return EXIT_SUCCESS;
+}
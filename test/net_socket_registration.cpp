@@ -0,0 +1,85 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+
+#include <coroutine/linux.h>
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+// the buffer is smaller than the message. the readiness must be kept for the next
+auto recv_all(int64_t sd, size_t total, size_t& received, uint32_t& ec)
+    -> no_return_t {
+    io_registration reg{sd};
+    io_work_t work{};
+    array<byte, 64> buf{};
+    while (received < total) {
+        const auto sz = co_await recv_stream(sd, buf, 0, work);
+        if (sz <= 0) {
+            ec = work.error();
+            co_return;
+        }
+        received += static_cast<size_t>(sz);
+    }
+}
+
+auto send_all(int64_t sd, size_t count, size_t& sent, uint32_t& ec)
+    -> no_return_t {
+    io_registration reg{sd};
+    io_work_t work{};
+    array<byte, 100> buf{};
+    buf.fill(byte{0xEE});
+    for (auto i = 0u; i < count; ++i) {
+        const auto sz = co_await send_stream(sd, buf, 0, work);
+        if (sz <= 0) {
+            ec = work.error();
+            co_return;
+        }
+        sent += static_cast<size_t>(sz);
+    }
+}
+
+int main(int, char*[]) {
+    int sds[2]{};
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sds) != 0)
+        return __LINE__;
+    auto on_return = gsl::finally([&sds]() {
+        close(sds[0]);
+        close(sds[1]);
+    });
+
+    size_t received = 0, sent = 0;
+    uint32_t rec = 0, sec = 0;
+    // the receiver is parked before the sender
+    recv_all(sds[0], 300, received, rec);
+    if (received != 0)
+        return __LINE__;
+    // the socket is writable. the sender won't suspend
+    send_all(sds[1], 3, sent, sec);
+    if (sec != 0 || sent != 300)
+        return __LINE__;
+
+    // prevent infinite loop for this test....
+    for (auto repeat = 100; repeat && received < 300 && rec == 0; --repeat)
+        poll_net_tasks(10'000'000);
+
+    if (rec != 0 || received != 300)
+        return __LINE__;
+    // the registration made the socket non-blocking
+    if ((fcntl(sds[0], F_GETFL, 0) & O_NONBLOCK) == 0)
+        return __LINE__;
+    // destroyed with the coroutines
+    if (io_registration::find(sds[0]) || io_registration::find(sds[1]))
+        return __LINE__;
+    return EXIT_SUCCESS;
+}
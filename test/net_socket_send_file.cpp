@@ -0,0 +1,133 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+/// @brief Loopback TCP connection. The sender is non-blocking
+int connect_pair(int64_t& sender, int64_t& receiver) {
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(local);
+    const auto ln = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (ln < 0)
+        return __LINE__;
+    auto on_return = gsl::finally([ln]() { close(ln); });
+    if (bind(ln, reinterpret_cast<sockaddr*>(&local), len) ||
+        getsockname(ln, reinterpret_cast<sockaddr*>(&local), &len) ||
+        listen(ln, 1))
+        return __LINE__;
+    sender = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (connect(sender, reinterpret_cast<sockaddr*>(&local), len))
+        return __LINE__;
+    receiver = accept4(ln, nullptr, nullptr, SOCK_NONBLOCK);
+    if (receiver < 0)
+        return __LINE__;
+    return fcntl(sender, F_SETFL, O_NONBLOCK) == 0 ? 0 : __LINE__;
+}
+
+auto send_all(int64_t sd, int64_t fd, int64_t size, int64_t& offset)
+    -> no_return_t {
+    io_work_t work{};
+    while (offset < size)
+        if (co_await send_file(sd, fd, offset, size - offset, work) <= 0)
+            co_return;
+}
+
+auto recv_all(int64_t sd, gsl::span<byte> buf, size_t& received)
+    -> no_return_t {
+    io_work_t work{};
+    while (received < buf.size()) {
+        const auto sz = co_await recv_stream(sd, buf.subspan(received), 0, work);
+        if (sz <= 0)
+            co_return;
+        received += static_cast<size_t>(sz);
+    }
+}
+
+/// @brief Send the buffer `count` times and wait for their completion
+auto send_zerocopy(int64_t sd, gsl::span<byte> buf, int64_t count,
+                   int64_t& completed) -> no_return_t {
+    io_work_t work{};
+    for (auto i = 0; i < count; ++i)
+        if (co_await send_stream(sd, buf, MSG_ZEROCOPY, work) !=
+            static_cast<int64_t>(buf.size()))
+            co_return;
+    // the other readiness may wake up the coroutine
+    for (auto repeat = 100; repeat && completed < count; --repeat)
+        completed = max(completed, co_await recv_zerocopy(sd, work));
+}
+
+int main(int, char*[]) {
+    int64_t sender = -1, receiver = -1;
+    auto on_return = gsl::finally([&]() {
+        close(sender);
+        close(receiver);
+    });
+    if (auto line = connect_pair(sender, receiver))
+        return line;
+
+    // file with a pattern
+    char path[] = "/tmp/coroutine_send_file_XXXXXX";
+    const auto fd = mkstemp(path);
+    if (fd < 0)
+        return __LINE__;
+    unlink(path);
+    auto on_exit = gsl::finally([fd]() { close(fd); });
+    vector<byte> content(256 * 1024);
+    for (auto i = 0u; i < content.size(); ++i)
+        content[i] = static_cast<byte>(i % 251);
+    if (write(fd, content.data(), content.size()) !=
+        static_cast<ssize_t>(content.size()))
+        return __LINE__;
+
+    // larger than the socket buffer. the sender will suspend
+    int64_t offset = 0;
+    size_t received = 0;
+    vector<byte> storage(content.size());
+    send_all(sender, fd, content.size(), offset);
+    recv_all(receiver, storage, received);
+    for (auto repeat = 1000; repeat && received < storage.size(); --repeat)
+        poll_net_tasks(10'000'000);
+    if (offset != static_cast<int64_t>(content.size()))
+        return __LINE__;
+    if (received != storage.size() || storage != content)
+        return __LINE__;
+
+    // the kernel may not support the zero-copy
+    int use = 1;
+    if (setsockopt(sender, SOL_SOCKET, SO_ZEROCOPY, &use, sizeof(use)))
+        return EXIT_SUCCESS;
+    constexpr int64_t count = 3;
+    int64_t completed = -1;
+    array<byte, 4000> buf{};
+    buf.fill(byte{7});
+    received = 0;
+    storage.resize(buf.size() * count);
+    send_zerocopy(sender, buf, count, completed);
+    recv_all(receiver, storage, received);
+    for (auto repeat = 1000; repeat && completed < count; --repeat)
+        poll_net_tasks(10'000'000);
+    if (completed != count)
+        return __LINE__;
+    if (received != storage.size())
+        return __LINE__;
+    for (auto b : storage)
+        if (b != byte{7})
+            return __LINE__;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto recv_once(int64_t sd, io_buffer_t buf, int64_t& rsz, uint32_t& ec)
+    -> no_return_t {
+    io_work_t work{};
+    rsz = co_await recv_stream(sd, buf, 0, work);
+    ec = work.error();
+}
+
+auto send_once(int64_t sd, io_buffer_t buf, int64_t& ssz, uint32_t& ec)
+    -> no_return_t {
+    io_work_t work{};
+    ssz = co_await send_stream(sd, buf, 0, work);
+    ec = work.error();
+}
+
+int main(int, char*[]) {
+    int sds[2]{};
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sds) != 0)
+        return __LINE__;
+    auto on_return = gsl::finally([&sds]() {
+        close(sds[0]);
+        close(sds[1]);
+    });
+
+    array<byte, 300> rbuf{}, sbuf{};
+    sbuf.fill(byte{0xEE});
+    int64_t rsz = 0, ssz = 0;
+    uint32_t rec = 1, sec = 1;
+    // the receiver waits for the sender
+    recv_once(sds[0], rbuf, rsz, rec);
+    send_once(sds[1], sbuf, ssz, sec);
+
+    // prevent infinite loop for this test....
+    for (auto repeat = 100; repeat && (rsz == 0 || ssz == 0); --repeat)
+        poll_net_tasks(10'000'000);
+
+    if (sec != 0 || rec != 0)
+        return __LINE__;
+    if (ssz != static_cast<int64_t>(sbuf.size()) || rsz != ssz)
+        return __LINE__;
+    if (rbuf[rsz - 1] != byte{0xEE})
+        return __LINE__;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+auto recv_once(int64_t sd, io_buffer_t buf, io_work_t& work, int64_t& rsz)
+    -> no_return_t {
+    rsz = co_await recv_stream(sd, buf, 0, work);
+}
+
+auto send_once(int64_t sd, io_buffer_t buf, io_work_t& work, int64_t& ssz)
+    -> no_return_t {
+    ssz = co_await send_stream(sd, buf, 0, work);
+}
+
+int exchange(int type) {
+    int sds[2]{};
+    if (socketpair(AF_UNIX, type, 0, sds) != 0)
+        return __LINE__;
+    auto on_return = gsl::finally([&sds]() {
+        close(sds[0]);
+        close(sds[1]);
+    });
+
+    array<byte, 300> rbuf{}, sbuf{};
+    sbuf.fill(byte{0xEE});
+    io_work_t rwork{}, swork{};
+    // same works for the same sockets. the blocking mode is not checked again
+    for (auto i = 0; i < 3; ++i) {
+        int64_t rsz = 0, ssz = 0;
+        send_once(sds[1], sbuf, swork, ssz);
+        // with io_uring, the blocking socket's operation is in the ring
+        for (auto repeat = 100; repeat && ssz == 0; --repeat)
+            poll_net_tasks(10'000'000);
+        if (ssz != static_cast<int64_t>(sbuf.size()) || swork.error() != 0)
+            return __LINE__;
+        recv_once(sds[0], rbuf, rwork, rsz);
+        for (auto repeat = 100; repeat && rsz == 0; --repeat)
+            poll_net_tasks(10'000'000);
+        if (rsz != ssz || rwork.error() != 0)
+            return __LINE__;
+        if (rbuf[rsz - 1] != byte{0xEE})
+            return __LINE__;
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int, char*[]) {
+    // the first try will succeed. `poll_net_tasks` is not required
+    if (auto ec = exchange(SOCK_STREAM | SOCK_NONBLOCK))
+        return ec;
+    // bypass to the blocking I/O
+    if (auto ec = exchange(SOCK_STREAM))
+        return ec;
+    return EXIT_SUCCESS;
+}
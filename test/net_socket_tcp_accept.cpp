@@ -0,0 +1,135 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+int64_t open_listener(sockaddr_in& local) {
+    const auto ln = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+    if (ln < 0)
+        return ln;
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = 0; // let system define the port
+    socklen_t len = sizeof(local);
+    if (bind(ln, reinterpret_cast<sockaddr*>(&local), len) ||
+        getsockname(ln, reinterpret_cast<sockaddr*>(&local), &len) ||
+        listen(ln, 16)) {
+        close(ln);
+        return -1;
+    }
+    return ln;
+}
+
+auto accept_all(int64_t ln, gsl::span<int64_t> sds, size_t& count)
+    -> no_return_t {
+    io_work_t work{};
+    while (count < sds.size()) {
+        const auto n = co_await accept_streams(ln, sds.subspan(count), work);
+        if (n < 0)
+            co_return;
+        count += static_cast<size_t>(n);
+    }
+}
+
+auto accept_one(int64_t ln, sockaddr_in& remote, int64_t& sd) -> no_return_t {
+    io_work_t work{};
+    sd = co_await accept_stream(ln, remote, work);
+}
+
+auto connect_to(int64_t sd, const sockaddr_in& remote, int64_t& result)
+    -> no_return_t {
+    io_work_t work{};
+    result = co_await connect_stream(sd, remote, work);
+}
+
+int main(int, char*[]) {
+    sockaddr_in local{};
+    const auto ln = open_listener(local);
+    if (ln < 0)
+        return __LINE__;
+    constexpr auto count = 3u;
+    array<int64_t, count + 1> clients{}, accepted{};
+    clients.fill(-1);
+    accepted.fill(-1);
+    auto on_return = gsl::finally([&]() {
+        for (auto sd : clients)
+            if (sd >= 0)
+                close(sd);
+        for (auto sd : accepted)
+            if (sd >= 0)
+                close(sd);
+        close(ln);
+    });
+
+    // the backlog is empty. suspend
+    size_t naccepted = 0;
+    accept_all(ln, gsl::span{accepted}.first(count), naccepted);
+    if (naccepted != 0)
+        return __LINE__;
+
+    constexpr int64_t pending = 1; // connect returns 0 or -1
+    array<int64_t, count + 1> results{};
+    results.fill(pending);
+    for (auto i = 0u; i < count; ++i) {
+        clients[i] = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+        connect_to(clients[i], local, results[i]);
+    }
+    // prevent infinite loop for this test....
+    for (auto repeat = 100; repeat && naccepted < count; --repeat)
+        poll_net_tasks(10'000'000);
+    if (naccepted != count)
+        return __LINE__;
+    for (auto i = 0u; i < count; ++i) {
+        for (auto repeat = 100; repeat && results[i] == pending; --repeat)
+            poll_net_tasks(10'000'000);
+        if (results[i] != 0)
+            return __LINE__;
+        // accepted socket is non-blocking
+        if ((fcntl(accepted[i], F_GETFL, 0) & O_NONBLOCK) == 0)
+            return __LINE__;
+    }
+
+    // with the remote address
+    sockaddr_in remote{};
+    clients[count] = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+    connect_to(clients[count], local, results[count]);
+    accept_one(ln, remote, accepted[count]);
+    for (auto repeat = 100; repeat && accepted[count] < 0; --repeat)
+        poll_net_tasks(10'000'000);
+    if (accepted[count] < 0 || remote.sin_family != AF_INET)
+        return __LINE__;
+    sockaddr_in client{};
+    socklen_t len = sizeof(client);
+    getsockname(clients[count], reinterpret_cast<sockaddr*>(&client), &len);
+    if (remote.sin_port != client.sin_port)
+        return __LINE__;
+
+    // nobody is listening
+    close(ln);
+    const auto sd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+    int64_t refused = pending;
+    connect_to(sd, local, refused);
+    for (auto repeat = 100; repeat && refused == pending; --repeat)
+        poll_net_tasks(10'000'000);
+    // the error is not EINPROGRESS. the coroutine doesn't retry forever
+    int ec = 0;
+    socklen_t eclen = sizeof(ec);
+    getsockopt(sd, SOL_SOCKET, SO_ERROR, &ec, &eclen);
+    close(sd);
+    if (refused != -1 || ec != 0)
+        return __LINE__;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <chrono>
+#include <cstdlib>
+
+#include <coroutine/linux.h>
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace std::chrono;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+static constexpr int64_t pending = 1; // 0 for EOF, -1 for error
+
+auto recv_once(int64_t sd, milliseconds timeout, int64_t& result,
+               uint32_t& ec) -> no_return_t {
+    io_work_t work{};
+    array<byte, 64> buf{};
+    result = co_await with_timeout(recv_stream(sd, buf, 0, work), timeout);
+    ec = work.error();
+}
+
+auto recv_registered(int64_t sd, milliseconds timeout, int64_t& result,
+                     uint32_t& ec) -> no_return_t {
+    io_registration reg{sd};
+    io_work_t work{};
+    array<byte, 64> buf{};
+    // the first one will be expired. the registration is kept
+    result = co_await with_timeout(recv_stream(sd, buf, 0, work), timeout);
+    ec = work.error();
+    if (result >= 0)
+        co_return;
+    result = co_await with_timeout(recv_stream(sd, buf, 0, work), 10s);
+}
+
+/// @brief poll until the result is changed, or the limit
+void wait_for(int64_t& result, milliseconds limit) {
+    const auto until = steady_clock::now() + limit;
+    while (result == pending && steady_clock::now() < until)
+        poll_net_tasks(duration_cast<nanoseconds>(10ms).count());
+}
+
+int main(int, char*[]) {
+    int sds[2]{};
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sds) != 0)
+        return __LINE__;
+    auto on_return = gsl::finally([&sds]() {
+        close(sds[0]);
+        close(sds[1]);
+    });
+    array<byte, 10> msg{};
+    const auto len = static_cast<int64_t>(msg.size());
+
+    // nobody sends. the receiver is resumed with ETIMEDOUT
+    int64_t result = pending;
+    uint32_t ec = 0;
+    const auto start = steady_clock::now();
+    recv_once(sds[0], 50ms, result, ec);
+    wait_for(result, 2s);
+    if (result != -1 || ec != ETIMEDOUT)
+        return __LINE__;
+    if (steady_clock::now() - start < 50ms)
+        return __LINE__;
+
+    // the socket was removed from the epoll. the next one must work
+    recv_once(sds[0], 5s, result = pending, ec = 0);
+    if (send(sds[1], msg.data(), msg.size(), 0) != len)
+        return __LINE__;
+    wait_for(result, 2s);
+    if (result != len || ec != 0)
+        return __LINE__;
+
+    // the deadline was disarmed. nothing will be resumed by the timer
+    if (poll_net_tasks(duration_cast<nanoseconds>(50ms).count()) != 0)
+        return __LINE__;
+
+    // the parked coroutine is taken out of the registration
+    recv_registered(sds[0], 30ms, result = pending, ec = 0);
+    wait_for(result, 2s);
+    if (result != -1 || ec != ETIMEDOUT)
+        return __LINE__;
+    result = pending;
+    if (send(sds[1], msg.data(), msg.size(), 0) != len)
+        return __LINE__;
+    wait_for(result, 2s);
+    if (result != len)
+        return __LINE__;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include <coroutine/linux.h>
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace std::chrono;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+static constexpr int64_t pending = 1; // 0 for EOF, -1 for error
+
+auto recv_once(int64_t sd, nanoseconds timeout, atomic<int64_t>& result,
+               uint32_t& ec) -> no_return_t {
+    io_work_t work{};
+    array<byte, 10> buf{};
+    const auto sz = co_await with_timeout(recv_stream(sd, buf, 0, work), timeout);
+    ec = work.error();
+    result.store(sz, memory_order_release);
+}
+
+/// @brief receive the remaining messages. the socket is non-blocking
+int64_t drain(int64_t sd) {
+    array<byte, 64> buf{};
+    int64_t total = 0;
+    for (auto sz = recv(sd, buf.data(), buf.size(), 0); sz > 0;
+         sz = recv(sd, buf.data(), buf.size(), 0))
+        total += sz;
+    return total;
+}
+
+/// @brief The deadline and the readiness are in the same `poll`. Only 1 of them resumes
+int race_in_batch(int64_t sd, int64_t peer) {
+    array<byte, 10> msg{};
+    const auto len = static_cast<int64_t>(msg.size());
+    atomic<int64_t> result{pending};
+    uint32_t ec = 0;
+    recv_once(sd, 10ms, result, ec);
+    this_thread::sleep_for(50ms); // the deadline is passed without the poll
+    if (send(peer, msg.data(), msg.size(), 0) != len)
+        return __LINE__;
+    if (poll_net_tasks(duration_cast<nanoseconds>(100ms).count()) != 1)
+        return __LINE__;
+    const auto sz = result.load();
+    if (sz == pending)
+        return __LINE__;
+    if (sz == -1) { // expired. the message is still in the socket
+        if (ec != ETIMEDOUT || drain(sd) != len)
+            return __LINE__;
+    } else if (sz != len || ec != 0)
+        return __LINE__;
+    // nothing is resumed again
+    if (poll_net_tasks(duration_cast<nanoseconds>(30ms).count()) != 0)
+        return __LINE__;
+    return 0;
+}
+
+/// @brief The other thread polls while the deadline is being armed
+int race_in_threads(int64_t sd, int64_t peer) {
+    atomic_bool stop{false};
+    thread poller{[&stop]() {
+        while (stop.load() == false)
+            poll_net_tasks(duration_cast<nanoseconds>(1ms).count());
+    }};
+    auto on_return = gsl::finally([&]() {
+        stop = true;
+        poller.join();
+    });
+    array<byte, 10> msg{};
+    const auto len = static_cast<int64_t>(msg.size());
+    int64_t received = 0;
+    for (auto i = 0; i < 300; ++i) {
+        atomic<int64_t> result{pending};
+        uint32_t ec = 0;
+        recv_once(sd, microseconds{i % 7 * 50}, result, ec);
+        if (send(peer, msg.data(), msg.size(), 0) != len)
+            return __LINE__;
+        const auto until = steady_clock::now() + 2s;
+        while (result.load() == pending)
+            if (steady_clock::now() > until) // the coroutine is lost
+                return __LINE__;
+        const auto sz = result.load();
+        if (sz == -1 && ec != ETIMEDOUT)
+            return __LINE__;
+        if (sz > 0)
+            received += sz;
+    }
+    stop = true;
+    this_thread::sleep_for(10ms);
+    // the expired ones left their messages
+    if (received + drain(sd) != 300 * len)
+        return __LINE__;
+    return 0;
+}
+
+int main(int, char*[]) {
+    int sds[2]{};
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sds) != 0)
+        return __LINE__;
+    auto on_return = gsl::finally([&sds]() {
+        close(sds[0]);
+        close(sds[1]);
+    });
+    if (auto line = race_in_batch(sds[0], sds[1]))
+        return line;
+    if (auto line = race_in_threads(sds[0], sds[1]))
+        return line;
+    // same with the registration
+    io_registration reg{sds[0]};
+    if (auto line = race_in_batch(sds[0], sds[1]))
+        return line;
+    if (auto line = race_in_threads(sds[0], sds[1]))
+        return line;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#include <coroutine/net.h>
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+#if defined(__GNUC__)
+using no_return_t = coro::null_frame_t;
+#else
+using no_return_t = std::nullptr_t;
+#endif
+
+constexpr auto batch = 8u;
+
+/// @brief `header` and `body` are gathered/scattered for 1 datagram
+struct slot_t final {
+    sockaddr_in6 remote;
+    uint32_t header;
+    array<byte, 60> body;
+    array<iovec, 2> iov;
+
+    void prepare(mmsghdr& m) noexcept {
+        iov[0] = {&header, sizeof(header)};
+        iov[1] = {body.data(), body.size()};
+        m = {};
+        m.msg_hdr.msg_name = &remote;
+        m.msg_hdr.msg_namelen = sizeof(remote);
+        m.msg_hdr.msg_iov = iov.data();
+        m.msg_hdr.msg_iovlen = iov.size();
+    }
+};
+
+int64_t open_udp6(sockaddr_in6& local) {
+    const auto sd = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    if (sd < 0)
+        return sd;
+    local.sin6_family = AF_INET6;
+    local.sin6_addr = in6addr_loopback;
+    local.sin6_port = 0; // let system define the port
+    socklen_t len = sizeof(local);
+    if (bind(sd, reinterpret_cast<sockaddr*>(&local), len) ||
+        getsockname(sd, reinterpret_cast<sockaddr*>(&local), &len)) {
+        close(sd);
+        return -1;
+    }
+    return sd;
+}
+
+auto recv_batch(int64_t sd, gsl::span<mmsghdr> msgs, int64_t& count)
+    -> no_return_t {
+    io_work_t work{};
+    count = co_await recv_mmsg(sd, msgs, 0, work);
+    if (work.error())
+        count = -1;
+}
+
+auto send_batch(int64_t sd, gsl::span<mmsghdr> msgs, int64_t& count)
+    -> no_return_t {
+    io_work_t work{};
+    count = co_await send_mmsg(sd, msgs, 0, work);
+    if (work.error())
+        count = -1;
+}
+
+auto recv_one(int64_t sd, msghdr& msg, int64_t& rsz) -> no_return_t {
+    io_work_t work{};
+    rsz = co_await recv_msg(sd, msg, 0, work);
+    if (work.error())
+        rsz = -1;
+}
+
+auto send_one(int64_t sd, const msghdr& msg, int64_t& ssz) -> no_return_t {
+    io_work_t work{};
+    ssz = co_await send_msg(sd, msg, 0, work);
+    if (work.error())
+        ssz = -1;
+}
+
+int main(int, char*[]) {
+    sockaddr_in6 addr1{}, addr2{};
+    const auto sd1 = open_udp6(addr1);
+    const auto sd2 = open_udp6(addr2);
+    if (sd1 < 0 || sd2 < 0)
+        return __LINE__;
+    auto on_return = gsl::finally([sd1, sd2]() {
+        close(sd1);
+        close(sd2);
+    });
+
+    array<slot_t, batch> rslots{}, sslots{};
+    array<mmsghdr, batch> rmsgs{}, smsgs{};
+    for (auto i = 0u; i < batch; ++i) {
+        rslots[i].prepare(rmsgs[i]);
+        sslots[i].prepare(smsgs[i]);
+        sslots[i].remote = addr1;
+        sslots[i].header = i;
+        sslots[i].body.fill(byte{0xEE});
+    }
+
+    // nothing to receive. suspend
+    int64_t rcount = 0, scount = 0;
+    recv_batch(sd1, rmsgs, rcount);
+    if (rcount != 0)
+        return __LINE__;
+    // all datagrams in 1 syscall
+    send_batch(sd2, smsgs, scount);
+    for (auto repeat = 100; repeat && scount == 0; --repeat)
+        poll_net_tasks(10'000'000);
+    if (scount != batch)
+        return __LINE__;
+    for (auto repeat = 100; repeat && rcount == 0; --repeat)
+        poll_net_tasks(10'000'000);
+    // the datagrams were queued before the resume
+    if (rcount != batch)
+        return __LINE__;
+    for (auto i = 0u; i < batch; ++i) {
+        if (rmsgs[i].msg_len != sizeof(uint32_t) + sslots[i].body.size())
+            return __LINE__;
+        if (rslots[i].header != i || rslots[i].body.back() != byte{0xEE})
+            return __LINE__;
+        if (rslots[i].remote.sin6_port != addr2.sin6_port)
+            return __LINE__;
+    }
+
+    // 1 datagram from 2 buffers. scattered to 2 buffers
+    mmsghdr rm{}, sm{};
+    rslots[0].prepare(rm);
+    sslots[0].prepare(sm);
+    sslots[0].header = 0xABCD;
+    int64_t rsz = 0, ssz = 0;
+    recv_one(sd1, rm.msg_hdr, rsz);
+    send_one(sd2, sm.msg_hdr, ssz);
+    for (auto repeat = 100; repeat && (rsz == 0 || ssz == 0); --repeat)
+        poll_net_tasks(10'000'000);
+    if (ssz != static_cast<int64_t>(sizeof(uint32_t) + sslots[0].body.size()))
+        return __LINE__;
+    if (rsz != ssz || rslots[0].header != 0xABCD)
+        return __LINE__;
+    return EXIT_SUCCESS;
+}
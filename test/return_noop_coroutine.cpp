@@ -0,0 +1,49 @@
+/**
+ * @author github.com/luncliff (luncliff@gmail.com)
+ */
+#undef NDEBUG
+#include <cassert>
+
+#include <coroutine/return.h>
+
+using namespace std;
+using namespace coro;
+
+/// @brief Transfer to the `noop_coroutine` in the final suspension
+struct noop_transfer_t final {
+    bool await_ready() noexcept {
+        return false;
+    }
+    coroutine_handle<void> await_suspend(coroutine_handle<void>) noexcept {
+        return noop_coroutine();
+    }
+    void await_resume() noexcept {
+    }
+};
+
+auto transfer_to_noop(int& status) -> frame_t {
+    status += 1;
+    co_await noop_transfer_t{};
+    status += 1;
+}
+
+int main(int, char*[]) {
+    auto noop = noop_coroutine();
+    assert(noop);
+    assert(noop.address() != nullptr);
+    assert(noop.done() == false);
+    noop.resume();
+
+    // resume through the type-erased handle. it must return to here
+    coroutine_handle<void> handle = noop;
+    handle.resume();
+
+    int status = 0;
+    coroutine_handle<void> coro = transfer_to_noop(status);
+    assert(status == 1); // returned to here with the transfer
+    coro.resume();
+    assert(status == 2);
+    assert(coro.done());
+    coro.destroy();
+    return 0;
+}